@@ -7,11 +7,13 @@ HEADERS += \
     src/*.h \
     src/core/*.h \
     src/commands/*.h \
-    src/subsystems/*.h
+    src/subsystems/*.h \
+    src/vision/*.h
 
 SOURCES += \
     src/*.cpp \
     src/core/*.cpp \
     src/commands/*.cpp \
     src/subsystems/*.cpp \
+    src/vision/*.cpp \
     src/core/robot.cpp
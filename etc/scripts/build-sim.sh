@@ -0,0 +1,22 @@
+#!/bin/bash
+
+# Description: This script builds the robot program against the WPILib
+#              stand-ins of sim/, so that it can run on a workstation.
+#              See sim/sim.h for the settings of the simulation.
+
+# Run from the root directory of the project
+cd "$(dirname ${BASH_SOURCE[0]})/../.."
+
+# Compiler settings
+CXX=${CXX:-g++}
+OUT=build/sim
+FLAGS="-std=c++14 -O2 -Wall -pthread -Isim -Isrc -Itools $CXXFLAGS"
+SOURCES="src/*.cpp src/core/*.cpp src/subsystems/*.cpp src/vision/*.cpp"
+
+mkdir -p $OUT
+
+# Build the robot program
+$CXX $FLAGS $SOURCES sim/*.cpp tools/common/frame_cache.cpp -o $OUT/robot || exit 1
+
+# Notify the user that we are done
+echo "Simulated robot built in $OUT"
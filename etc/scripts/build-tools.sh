@@ -0,0 +1,29 @@
+#!/bin/bash
+
+# Description: This script builds the workstation tools (vision benchmarks,
+#              replay harness...) with the host compiler. These tools are
+#              not part of the robot program and need libjpeg.
+
+# Run from the root directory of the project
+cd "$(dirname ${BASH_SOURCE[0]})/../.."
+
+# Compiler settings
+CXX=${CXX:-g++}
+OUT=build/tools
+FLAGS="-std=c++14 -O2 -Wall -pthread -Isrc -Itools $CXXFLAGS"
+VISION="src/vision/*.cpp tools/common/*.cpp"
+
+mkdir -p $OUT
+
+# Build each tool
+$CXX $FLAGS $VISION tools/vision-bench/*.cpp -ljpeg -o $OUT/vision-bench || exit 1
+$CXX $FLAGS $VISION tools/vision-stream/*.cpp -ljpeg -o $OUT/vision-stream || exit 1
+$CXX $FLAGS $VISION tools/vision-replay/*.cpp -ljpeg -o $OUT/vision-replay || exit 1
+$CXX $FLAGS $VISION tools/vision-sweep/*.cpp -ljpeg -o $OUT/vision-sweep || exit 1
+$CXX $FLAGS $VISION tools/corpus-pack/*.cpp -ljpeg -o $OUT/corpus-pack || exit 1
+$CXX $FLAGS src/core/telemetry_log.cpp tools/telemetry-diff/*.cpp -o $OUT/telemetry-diff || exit 1
+$CXX $FLAGS src/core/routine.cpp tools/routine-compile/*.cpp -o $OUT/routine-compile || exit 1
+$CXX $FLAGS src/core/input_shaping.cpp tools/input-bench/*.cpp -o $OUT/input-bench || exit 1
+
+# Notify the user that we are done
+echo "Tools built in $OUT"
@@ -0,0 +1,30 @@
+#!/bin/bash
+
+# Description: This script plays a telemetry log recorded by the robot in
+#              the simulation, and checks that the robot program still
+#              produces the same outputs.
+#
+# Usage:       replay.sh <log> [speed]
+#              The speed is the same as KZ_SIM_SPEED (0 is as fast as
+#              possible, which is the default)
+
+if [ -z "$1" ]; then
+    echo "Usage: $0 <log> [speed]"
+    exit 1
+fi
+
+LOG=$(readlink -f "$1")
+SPEED=${2:-0}
+
+# Run from the root directory of the project
+cd "$(dirname ${BASH_SOURCE[0]})/../.."
+
+./etc/scripts/build-sim.sh > /dev/null || exit 1
+./etc/scripts/build-tools.sh > /dev/null || exit 1
+
+# Record the replayed loops in a temporary directory
+OUT=$(mktemp -d)
+trap "rm -rf $OUT" EXIT
+
+KZ_SIM_REPLAY="$LOG" KZ_SIM_SPEED=$SPEED KZ_TELEMETRY_DIR=$OUT ./build/sim/robot || exit 1
+./build/tools/telemetry-diff "$LOG" $OUT/telemetry-*.bin
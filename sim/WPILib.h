@@ -0,0 +1,523 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+///
+/// Stand-in for the WPILib.h header of the roboRIO, which lets the robot
+/// program be built and run on a workstation (see etc/scripts/build-sim.sh).
+///
+/// Only the classes and functions used by the robot program are provided,
+/// with the same names and signatures as WPILib 2016. Actuators record their
+/// outputs, sensors and joysticks read the values given by the simulation
+/// script, and the clock is the simulated time (see sim.h).
+///
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// HAL
+//------------------------------------------------------------------------------
+
+namespace HALUsageReporting {
+enum tResourceType {
+    kResourceType_Language = 20,
+};
+
+enum tInstances {
+    kLanguage_CPlusPlus = 2,
+};
+}
+
+int HALInitialize (int mode = 0);
+int HALReport (uint8_t resource,
+               uint8_t instanceNumber,
+               uint8_t context = 0,
+               const char* feature = nullptr);
+
+//------------------------------------------------------------------------------
+// Robot base classes
+//------------------------------------------------------------------------------
+
+class RobotBase {
+  public:
+    virtual ~RobotBase() {}
+
+    bool IsEnabled() const;
+    bool IsDisabled() const;
+    bool IsAutonomous() const;
+    bool IsOperatorControl() const;
+    bool IsTest() const;
+
+    virtual void StartCompetition() = 0;
+    static void robotSetup (RobotBase* robot);
+};
+
+class IterativeRobot : public RobotBase {
+  public:
+    virtual void StartCompetition() override;
+
+    virtual void RobotInit() {}
+    virtual void DisabledInit() {}
+    virtual void AutonomousInit() {}
+    virtual void TeleopInit() {}
+    virtual void TestInit() {}
+
+    virtual void DisabledPeriodic() {}
+    virtual void AutonomousPeriodic() {}
+    virtual void TeleopPeriodic() {}
+    virtual void TestPeriodic() {}
+};
+
+//------------------------------------------------------------------------------
+// Timing
+//------------------------------------------------------------------------------
+
+class Timer {
+  public:
+    Timer();
+
+    double Get() const;
+    void Reset();
+    void Start();
+    void Stop();
+    bool HasPeriodPassed (double period);
+
+    static double GetFPGATimestamp();
+
+  private:
+    double m_startTime;
+    double m_accumulatedTime;
+    bool m_running;
+};
+
+void Wait (double seconds);
+
+typedef std::function<void()> TimerEventHandler;
+
+///
+/// Calls the handler at the given times of the simulated clock. The handlers
+/// are called by the simulation between two loops of the robot program, so
+/// the results do not depend on the speed of the simulation.
+///
+class Notifier {
+  public:
+    explicit Notifier (TimerEventHandler handler);
+
+    template <typename Callable, typename Arg, typename... Args>
+    Notifier (Callable&& f, Arg&& arg, Args&& ... args) :
+        Notifier (std::bind (std::forward<Callable> (f),
+                             std::forward<Arg> (arg),
+                             std::forward<Args> (args)...)) {}
+
+    virtual ~Notifier();
+
+    void StartSingle (double delay);
+    void StartPeriodic (double period);
+    void Stop();
+
+    /* Used by the simulation */
+    bool IsActive() const;
+    double GetNextTime() const;
+    void Fire();
+
+  private:
+    TimerEventHandler m_handler;
+    double m_period;
+    double m_next;
+    bool m_periodic;
+    bool m_active;
+};
+
+//------------------------------------------------------------------------------
+// Driver station
+//------------------------------------------------------------------------------
+
+class Joystick {
+  public:
+    explicit Joystick (uint32_t port);
+
+    float GetX() const;
+    float GetY() const;
+    float GetRawAxis (uint32_t axis) const;
+    bool GetRawButton (uint32_t button) const;
+    int GetPOV (uint32_t pov = 0) const;
+    int GetAxisCount() const;
+    int GetButtonCount() const;
+
+  private:
+    uint32_t m_port;
+};
+
+class DriverStation {
+  public:
+    static const uint32_t kJoystickPorts = 6;
+
+    static DriverStation& GetInstance();
+
+    float GetStickAxis (uint32_t stick, uint32_t axis);
+    int GetStickPOV (uint32_t stick, uint32_t pov);
+    uint32_t GetStickButtons (uint32_t stick) const;
+    std::string GetJoystickName (uint32_t stick) const;
+    bool IsDSAttached() const;
+
+  private:
+    DriverStation() {}
+};
+
+class SmartDashboard {
+  public:
+    static void PutNumber (const std::string& key, double value);
+    static void PutBoolean (const std::string& key, bool value);
+    static void PutString (const std::string& key, const std::string& value);
+
+    static double GetNumber (const std::string& key, double defaultValue);
+    static bool GetBoolean (const std::string& key, bool defaultValue);
+    static std::string GetString (const std::string& key, const std::string& defaultValue);
+};
+
+//------------------------------------------------------------------------------
+// Actuators
+//------------------------------------------------------------------------------
+
+class PIDOutput {
+  public:
+    virtual ~PIDOutput() {}
+
+    virtual void PIDWrite (float output) = 0;
+};
+
+class SpeedController : public PIDOutput {
+  public:
+    virtual ~SpeedController() {}
+
+    virtual void Set (float speed, uint8_t syncGroup = 0) = 0;
+    virtual float Get() const = 0;
+    virtual void SetInverted (bool isInverted) = 0;
+    virtual bool GetInverted() const = 0;
+    virtual void Disable() = 0;
+    virtual void StopMotor();
+};
+
+///
+/// Common part of the simulated speed controllers: the output is recorded
+/// under the given name (for example "PWM1" or "CAN2")
+///
+class SimSpeedController : public SpeedController {
+  public:
+    explicit SimSpeedController (const std::string& name);
+    virtual ~SimSpeedController();
+
+    virtual void Set (float speed, uint8_t syncGroup = 0) override;
+    virtual float Get() const override;
+    virtual void SetInverted (bool isInverted) override;
+    virtual bool GetInverted() const override;
+    virtual void Disable() override;
+    virtual void PIDWrite (float output) override;
+
+    void SetSafetyEnabled (bool enabled);
+    bool IsSafetyEnabled() const;
+    void SetExpiration (double timeout);
+
+  protected:
+    float m_output;
+    bool m_inverted;
+    bool m_safetyEnabled;
+};
+
+class Talon : public SimSpeedController {
+  public:
+    explicit Talon (uint32_t channel);
+};
+
+class Victor : public SimSpeedController {
+  public:
+    explicit Victor (uint32_t channel);
+};
+
+class CANSpeedController : public SimSpeedController {
+  public:
+    enum ControlMode {
+        kPercentVbus = 0,
+        kCurrent = 1,
+        kSpeed = 2,
+        kPosition = 3,
+        kVoltage = 4,
+        kFollower = 5,
+    };
+
+    enum NeutralMode {
+        kNeutralMode_Jumper = 0,
+        kNeutralMode_Brake = 1,
+        kNeutralMode_Coast = 2,
+    };
+
+    explicit CANSpeedController (const std::string& name) : SimSpeedController (name) {}
+};
+
+///
+/// Every Set() or Disable() of a CANTalon is counted as a CAN frame.
+///
+/// The motor is simulated as a first order system (see kFreeSpeed and
+/// kTimeConstant), driven by the output in percent mode or by the closed
+/// loop of the Talon in speed mode, so that the encoder readings follow the
+/// commands. In neutral (an output of 0), a Talon set to coast draws no
+/// current and its motor slows down by friction (see kCoastTimeConstant),
+/// otherwise it brakes the motor (the jumper of the simulated Talons is set
+/// to brake).
+///
+class CANTalon : public CANSpeedController {
+  public:
+    enum FeedbackDevice {
+        QuadEncoder = 0,
+    };
+
+    static constexpr double kFreeSpeed = 5300;
+    static constexpr double kStallCurrent = 131;
+    static constexpr double kTimeConstant = 0.25;
+    static constexpr double kCoastTimeConstant = 2;
+    static constexpr double kNominalVoltage = 12;
+
+    explicit CANTalon (int deviceNumber);
+    virtual ~CANTalon();
+
+    virtual void Set (float value, uint8_t syncGroup = 0) override;
+    virtual void Disable() override;
+
+    void SetControlMode (ControlMode mode);
+    ControlMode GetControlMode() const;
+    void SetFeedbackDevice (FeedbackDevice device);
+    void ConfigEncoderCodesPerRev (uint16_t codesPerRev);
+    void SetSensorDirection (bool reverseSensor);
+    void SetPID (double p, double i, double d, double f);
+    void ConfigPeakOutputVoltage (double forwardVoltage, double reverseVoltage);
+    void ConfigNeutralMode (NeutralMode mode);
+
+    double GetSpeed() const;
+    double GetPosition() const;
+    void SetPosition (double position);
+    int GetClosedLoopError() const;
+    double GetOutputCurrent() const;
+    int GetDeviceID() const;
+
+    /* Used by the simulation, the motor is moved up to the current time */
+    void Update() const;
+    double GetMotorPosition() const;
+    double GetAppliedOutput() const;
+    double GetSpeedRatio() const;
+    double GetBrakingCurrent() const;
+    bool GetNeutralCoast() const;
+    bool IsCoasting() const;
+
+  private:
+    double nativeUnits (double rpm) const;
+
+    int m_deviceNumber;
+
+    ControlMode m_mode;
+    uint16_t m_codesPerRev;
+    bool m_reverseSensor;
+    double m_p;
+    double m_i;
+    double m_d;
+    double m_f;
+    double m_peakForward;
+    double m_peakReverse;
+    bool m_coast;
+    mutable double m_integral;
+    mutable double m_lastError;
+
+    double m_demand;
+    mutable double m_applied;
+    mutable double m_speed;
+    mutable double m_position;
+    mutable double m_lastUpdate;
+};
+
+class RobotDrive {
+  public:
+    RobotDrive (SpeedController* leftMotor, SpeedController* rightMotor);
+    RobotDrive (SpeedController* frontLeftMotor, SpeedController* rearLeftMotor,
+                SpeedController* frontRightMotor, SpeedController* rearRightMotor);
+
+    void ArcadeDrive (float moveValue, float rotateValue, bool squaredInputs = true);
+    void TankDrive (float leftValue, float rightValue, bool squaredInputs = true);
+    void SetLeftRightMotorOutputs (float leftOutput, float rightOutput);
+    void SetMaxOutput (double maxOutput);
+    void SetSafetyEnabled (bool enabled);
+    void SetExpiration (double timeout);
+    void StopMotor();
+
+  private:
+    SpeedController* m_frontLeftMotor;
+    SpeedController* m_frontRightMotor;
+    SpeedController* m_rearLeftMotor;
+    SpeedController* m_rearRightMotor;
+    double m_maxOutput;
+};
+
+class PowerDistributionPanel {
+  public:
+    PowerDistributionPanel();
+    explicit PowerDistributionPanel (uint8_t module);
+
+    double GetVoltage() const;
+};
+
+class Compressor {
+  public:
+    explicit Compressor (uint8_t pcmID = 0);
+    ~Compressor();
+
+    void Start();
+    void Stop();
+    bool Enabled() const;
+    void SetClosedLoopControl (bool on);
+    bool GetClosedLoopControl() const;
+    bool GetPressureSwitchValue() const;
+    float GetCompressorCurrent() const;
+
+    /* Used by the simulation */
+    void Update();
+
+  private:
+    std::string m_name;
+    float m_output;
+    bool m_closedLoop;
+};
+
+class DoubleSolenoid {
+  public:
+    enum Value {
+        kOff,
+        kForward,
+        kReverse
+    };
+
+    DoubleSolenoid (uint32_t forwardChannel, uint32_t reverseChannel);
+    DoubleSolenoid (uint8_t moduleNumber, uint32_t forwardChannel, uint32_t reverseChannel);
+    ~DoubleSolenoid();
+
+    void Set (Value value);
+    Value Get() const;
+
+  private:
+    float m_output;
+    Value m_piston;
+};
+
+//------------------------------------------------------------------------------
+// Sensors
+//------------------------------------------------------------------------------
+
+class Ultrasonic {
+  public:
+    enum DistanceUnit {
+        kInches = 0,
+        kMilliMeters = 1
+    };
+
+    Ultrasonic (uint32_t pingChannel, uint32_t echoChannel, DistanceUnit units = kInches);
+
+    double GetRangeInches() const;
+    double GetRangeMM() const;
+    bool IsRangeValid() const;
+    void SetAutomaticMode (bool enabling);
+    void Ping();
+
+  private:
+    std::string m_name;
+    std::atomic<double> m_pingTime;
+};
+
+//------------------------------------------------------------------------------
+// Camera (NI Vision and USBCamera)
+//------------------------------------------------------------------------------
+
+enum ImageType {
+    IMAQ_IMAGE_U8 = 0,
+    IMAQ_IMAGE_RGB = 4,
+};
+
+struct RGBValue {
+    unsigned char B;
+    unsigned char G;
+    unsigned char R;
+    unsigned char alpha;
+};
+
+struct Image {
+    ImageType type;
+    int width;
+    int height;
+    std::vector<RGBValue> pixels;
+};
+
+struct ImageInfo {
+    ImageType imageType;
+    int xRes;
+    int yRes;
+    int border;
+    int pixelsPerLine;
+    void* imageStart;
+};
+
+Image* imaqCreateImage (ImageType type, int borderSize);
+int imaqDispose (void* object);
+int imaqGetImageInfo (const Image* image, ImageInfo* info);
+
+class USBCamera {
+  public:
+    USBCamera (std::string name, bool useJpeg);
+
+    void OpenCamera();
+    void CloseCamera();
+    void StartCapture();
+    void StopCapture();
+    void SetFPS (double fps);
+    void SetSize (unsigned int width, unsigned int height);
+    void GetImage (Image* image);
+
+  private:
+    std::string m_name;
+    double m_fps;
+    unsigned int m_width;
+    unsigned int m_height;
+    double m_nextFrame;
+    size_t m_frame;
+};
+
+class CameraServer {
+  public:
+    static CameraServer* GetInstance();
+
+    void StartAutomaticCapture (const char* cameraName = "cam0");
+    void SetImage (const Image* image);
+    void SetQuality (unsigned int quality);
+};
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "WPILib.h"
+#include "sim.h"
+
+#include <math.h>
+#include <string.h>
+#include <thread>
+
+#include "common/frame_cache.h"
+
+//===============================================================================
+// openFrames
+//===============================================================================
+
+static FrameCache* openFrames() {
+    FrameCache* cache = new FrameCache;
+    if (const char* path = getenv ("KZ_SIM_FRAMES")) {
+        if (!cache->open (path))
+            fprintf (stderr, "Sim: invalid frame cache %s\n", path);
+    }
+
+    return cache;
+}
+
+//===============================================================================
+// frames
+//===============================================================================
+
+///
+/// Returns the frame cache given by KZ_SIM_FRAMES, or nullptr if there is
+/// none (the cameras then give black images).
+///
+/// The cache is never destroyed: the simulation can exit (on a failure)
+/// while the camera threads still read it.
+///
+static const FrameCache* frames() {
+    static FrameCache* cache = openFrames();
+    return cache->count() > 0 ? cache : nullptr;
+}
+
+//===============================================================================
+// imaqCreateImage
+//===============================================================================
+
+Image* imaqCreateImage (ImageType type, int borderSize) {
+    (void) borderSize;
+
+    Image* image = new Image;
+    image->type = type;
+    image->width = 0;
+    image->height = 0;
+    return image;
+}
+
+//===============================================================================
+// imaqDispose
+//===============================================================================
+
+int imaqDispose (void* object) {
+    delete (Image*) object;
+    return 1;
+}
+
+//===============================================================================
+// imaqGetImageInfo
+//===============================================================================
+
+int imaqGetImageInfo (const Image* image, ImageInfo* info) {
+    if (!image || !info)
+        return 0;
+
+    info->imageType = image->type;
+    info->xRes = image->width;
+    info->yRes = image->height;
+    info->border = 0;
+    info->pixelsPerLine = image->width;
+    info->imageStart = image->pixels.empty() ? nullptr : (void*) image->pixels.data();
+    return 1;
+}
+
+//===============================================================================
+// USBCamera
+//===============================================================================
+
+USBCamera::USBCamera (std::string name, bool useJpeg) :
+    m_name (name),
+    m_fps (30),
+    m_width (320),
+    m_height (240),
+    m_nextFrame (0),
+    m_frame (0) {
+    (void) useJpeg;
+}
+
+void USBCamera::OpenCamera() {}
+void USBCamera::CloseCamera() {}
+void USBCamera::StartCapture() {}
+void USBCamera::StopCapture() {}
+
+void USBCamera::SetFPS (double fps) {
+    m_fps = fps;
+}
+
+void USBCamera::SetSize (unsigned int width, unsigned int height) {
+    m_width = width;
+    m_height = height;
+}
+
+///
+/// Waits for the next frame on the simulated clock, and copies the next
+/// frame of the cache (if any) into the image. The image is left empty once
+/// the simulation has ended.
+///
+/// When the script places a vision target, its frame is shown instead,
+/// shifted horizontally by the bearing of the target.
+///
+void USBCamera::GetImage (Image* image) {
+    while (Sim::running() && Sim::now() < m_nextFrame)
+        std::this_thread::sleep_for (std::chrono::milliseconds (1));
+
+    m_nextFrame = std::max (m_nextFrame, Sim::now()) + 1 / m_fps;
+
+    if (!Sim::running()) {
+        image->width = image->height = 0;
+        image->pixels.clear();
+        return;
+    }
+
+    image->width = m_width;
+    image->height = m_height;
+    image->pixels.resize ((size_t) m_width * m_height);
+
+    double bearing = 0;
+    int index = -1;
+    const bool target = Sim::target (bearing, index);
+    if (index < 0)
+        index = (int) m_frame++;
+
+    Frame frame;
+    const FrameCache* cache = frames();
+    if (cache)
+        cache->frame (index % cache->count(), frame);
+
+    if (frame.width != (int) m_width || frame.height != (int) m_height ||
+        frame.channels != 3) {
+        memset (image->pixels.data(), 0, image->pixels.size() * sizeof (RGBValue));
+        return;
+    }
+
+    int shift = 0;
+    if (target) {
+        const double focal = m_width / 2 / tan (Sim::kCameraFOV / 2 * M_PI / 180);
+        shift = (int) lround (focal * tan (bearing * M_PI / 180));
+    }
+
+    for (int y = 0; y < (int) m_height; ++y) {
+        for (int x = 0; x < (int) m_width; ++x) {
+            RGBValue& pixel = image->pixels[(size_t) y * m_width + x];
+            const int source = x - shift;
+
+            if (source < 0 || source >= (int) m_width) {
+                memset (&pixel, 0, sizeof (pixel));
+                continue;
+            }
+
+            const uint8_t* bgr = frame.data() + (size_t) y * frame.stride() + source * 3;
+            pixel.B = bgr[0];
+            pixel.G = bgr[1];
+            pixel.R = bgr[2];
+            pixel.alpha = 0;
+        }
+    }
+}
+
+//===============================================================================
+// CameraServer
+//===============================================================================
+
+CameraServer* CameraServer::GetInstance() {
+    static CameraServer server;
+    return &server;
+}
+
+void CameraServer::StartAutomaticCapture (const char* cameraName) {
+    (void) cameraName;
+}
+
+void CameraServer::SetImage (const Image* image) {
+    (void) image;
+}
+
+void CameraServer::SetQuality (unsigned int quality) {
+    (void) quality;
+}
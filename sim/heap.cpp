@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sim.h"
+
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+///
+/// Set on the thread that runs the robot program to the loop it is in (a
+/// Periodic function or a notifier), the allocations made then are counted
+/// for that loop.
+///
+/// The operators are kept in their own file so that the compiler does not
+/// see the allocations of the standard library and their release together.
+///
+static thread_local Sim::Loop t_loop = Sim::kNoLoop;
+static std::atomic<uint64_t> s_loopAllocations[Sim::kLoops];
+
+void* operator new (size_t size) {
+    if (t_loop != Sim::kNoLoop)
+        ++s_loopAllocations[t_loop];
+
+    if (void* pointer = malloc (size ? size : 1))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (size_t size) {
+    return operator new (size);
+}
+
+void* operator new (size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new (size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[] (size_t size, const std::nothrow_t&) noexcept {
+    return operator new (size, std::nothrow);
+}
+
+void operator delete (void* pointer) noexcept {
+    free (pointer);
+}
+
+void operator delete (void* pointer, size_t) noexcept {
+    free (pointer);
+}
+
+void operator delete[] (void* pointer) noexcept {
+    free (pointer);
+}
+
+void operator delete[] (void* pointer, size_t) noexcept {
+    free (pointer);
+}
+
+//===============================================================================
+// Sim::setLoop
+//===============================================================================
+
+void Sim::setLoop (Loop loop) {
+    t_loop = loop;
+}
+
+//===============================================================================
+// Sim::loopAllocations
+//===============================================================================
+
+uint64_t Sim::loopAllocations (Loop loop) {
+    return s_loopAllocations[loop];
+}
@@ -0,0 +1,1042 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sim.h"
+#include "WPILib.h"
+#include "core/telemetry_log.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <vector>
+
+const int kMaxJoysticks = 6;
+const int kMaxAxes = 12;
+const int kMaxButtons = 32;
+
+///
+/// Sensor that receives the ultrasonic range of a replayed telemetry log
+/// (the ultrasonic sensor of the shooter)
+///
+const char* const kReplayRangeSensor = "Ultrasonic1";
+
+///
+/// Sensors that place the vision target (see sim.h)
+///
+const char* const kTargetSensor = "TargetBearing";
+const char* const kFrameSensor = "CameraFrame";
+
+///
+/// Number of loops whose heading is kept for the simulated cameras
+///
+const int kHeadingHistory = 64;
+
+///
+/// An input of the simulation script
+///
+struct Event {
+    enum Type {
+        kMode,
+        kAxis,
+        kButton,
+        kPov,
+        kSensor,
+        kEnd,
+    };
+
+    double time;
+    Type type;
+    int port;
+    int index;
+    double value;
+    std::string name;
+};
+
+///
+/// Everything the simulation knows about the robot and the driver station
+///
+struct State {
+    std::vector<Event> events;
+    size_t nextEvent;
+
+    std::atomic<int64_t> micros;
+    std::atomic<bool> running;
+    bool attached;
+    double speed;
+    std::chrono::steady_clock::time_point wallStart;
+    std::chrono::steady_clock::time_point loopStart;
+
+    Sim::Mode mode;
+    float axes[kMaxJoysticks][kMaxAxes];
+    bool buttons[kMaxJoysticks][kMaxButtons];
+    int povs[kMaxJoysticks];
+    std::string controllers[kMaxJoysticks];
+    std::map<std::string, double> sensors;
+
+    std::vector<std::pair<std::string, const float*>> outputs;
+    std::vector<Notifier*> notifiers;
+    std::vector<CANTalon*> talons;
+    std::vector<Compressor*> compressors;
+
+    std::atomic<double> heading;
+    std::atomic<double> pastHeadings[kHeadingHistory];
+    std::atomic<uint32_t> headingCount;
+    std::atomic<double> targetBearing;
+    std::atomic<int> cameraFrame;
+    std::atomic<bool> hasTarget;
+    float headingOutput;
+    float distanceOutput;
+    float xOutput;
+    float yOutput;
+    double distance;
+    double x;
+    double y;
+    std::vector<std::pair<double, double>> headings;
+    std::vector<size_t> aims;
+
+    std::atomic<bool> pressureLow;
+    double pressure;
+    double voltage;
+    double minVoltage;
+    float pressureOutput;
+    float voltageOutput;
+    uint64_t pneumaticsCommands;
+    double sampleTime;
+    double brownoutTime;
+    double coastBraking;
+
+    FILE* log;
+    bool headerWritten;
+    std::vector<double> loopTimes;
+    uint64_t busFrames;
+    uint64_t enabledLoops;
+
+    State() : nextEvent (0), micros (0), running (false), attached (false), speed (1),
+        mode (Sim::kDisabled), heading (0), headingCount (0), targetBearing (0),
+        cameraFrame (-1), hasTarget (false),
+        headingOutput (0), distanceOutput (0), xOutput (0), yOutput (0), distance (0),
+        x (0), y (0), pressureLow (true), pressure (Sim::kInitialPressure),
+        voltage (Sim::kBatteryVoltage), minVoltage (Sim::kBatteryVoltage),
+        pressureOutput (Sim::kInitialPressure), voltageOutput (Sim::kBatteryVoltage),
+        pneumaticsCommands (0), sampleTime (0), brownoutTime (0), coastBraking (0),
+        log (nullptr), headerWritten (false), busFrames (0), enabledLoops (0) {
+        memset (axes, 0, sizeof (axes));
+        memset (buttons, 0, sizeof (buttons));
+        std::fill (povs, povs + kMaxJoysticks, -1);
+
+        for (int i = 0; i < kHeadingHistory; ++i)
+            pastHeadings[i] = 0;
+    }
+};
+
+static State s_state;
+
+//===============================================================================
+// parseMode
+//===============================================================================
+
+static bool parseMode (const char* text, int& mode) {
+    static const char* kNames[] = { "disabled", "autonomous", "teleop", "test" };
+
+    for (int i = 0; i < 4; ++i) {
+        if (strcmp (text, kNames[i]) == 0) {
+            mode = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//===============================================================================
+// parseEvent
+//===============================================================================
+
+static bool parseEvent (const char* line, Event& event) {
+    char type[32] = "";
+    char name[64] = "";
+    int read = 0;
+
+    if (sscanf (line, "%lf %31s%n", &event.time, type, &read) != 2)
+        return false;
+
+    const char* args = line + read;
+    event.port = event.index = 0;
+    event.value = 0;
+
+    if (strcmp (type, "mode") == 0) {
+        int mode = 0;
+        event.type = Event::kMode;
+        event.value = 0;
+
+        if (sscanf (args, "%63s", name) != 1 || !parseMode (name, mode))
+            return false;
+
+        event.value = mode;
+        return true;
+    }
+
+    if (strcmp (type, "axis") == 0) {
+        event.type = Event::kAxis;
+        return sscanf (args, "%d %d %lf", &event.port, &event.index, &event.value) == 3 &&
+               event.port >= 0 && event.port < kMaxJoysticks &&
+               event.index >= 0 && event.index < kMaxAxes;
+    }
+
+    if (strcmp (type, "button") == 0) {
+        event.type = Event::kButton;
+        return sscanf (args, "%d %d %lf", &event.port, &event.index, &event.value) == 3 &&
+               event.port >= 0 && event.port < kMaxJoysticks &&
+               event.index >= 1 && event.index < kMaxButtons;
+    }
+
+    if (strcmp (type, "pov") == 0) {
+        event.type = Event::kPov;
+        return sscanf (args, "%d %lf", &event.port, &event.value) == 2 &&
+               event.port >= 0 && event.port < kMaxJoysticks;
+    }
+
+    if (strcmp (type, "sensor") == 0) {
+        event.type = Event::kSensor;
+        if (sscanf (args, "%63s %lf", name, &event.value) != 2)
+            return false;
+
+        event.name = name;
+        return true;
+    }
+
+    if (strcmp (type, "end") == 0) {
+        event.type = Event::kEnd;
+        return true;
+    }
+
+    return false;
+}
+
+//===============================================================================
+// loadScript
+//===============================================================================
+
+static bool loadScript (const char* path) {
+    std::vector<Event>& events = s_state.events;
+    events.clear();
+
+    if (!path) {
+        const char* match[] = {
+            "0 mode disabled", "1 mode autonomous", "16 mode teleop", "31 end"
+        };
+
+        for (const char* line : match) {
+            Event event;
+            parseEvent (line, event);
+            events.push_back (event);
+        }
+
+        return true;
+    }
+
+    FILE* file = fopen (path, "r");
+    if (!file) {
+        fprintf (stderr, "Sim: cannot open %s\n", path);
+        return false;
+    }
+
+    char line[256];
+    int number = 0;
+    bool valid = true;
+
+    while (fgets (line, sizeof (line), file)) {
+        ++number;
+
+        const char* text = line + strspn (line, " \t");
+        if (*text == '#' || *text == '\n' || *text == '\r' || *text == '\0')
+            continue;
+
+        Event event;
+        if (!parseEvent (text, event)) {
+            fprintf (stderr, "Sim: invalid event at %s:%d\n", path, number);
+            valid = false;
+        }
+
+        events.push_back (event);
+    }
+
+    fclose (file);
+
+    /* Events of the same time keep the order of the file */
+    std::stable_sort (events.begin(), events.end(),
+    [] (const Event & a, const Event & b) {
+        return a.time < b.time;
+    });
+
+    return valid;
+}
+
+//===============================================================================
+// addEvent
+//===============================================================================
+
+static void addEvent (double time, Event::Type type, int port, int index, double value,
+                      const char* name = "") {
+    Event event;
+    event.time = time;
+    event.type = type;
+    event.port = port;
+    event.index = index;
+    event.value = value;
+    event.name = name;
+    s_state.events.push_back (event);
+}
+
+//===============================================================================
+// loadReplay
+//===============================================================================
+
+///
+/// Turns a telemetry log into script events: each record becomes a loop, in
+/// the mode of the record and with its joystick and ultrasonic values. The
+/// robot was disabled when there are no records for more than one loop. The
+/// joysticks are the controllers named by the log.
+///
+static bool loadReplay (const char* path) {
+    std::vector<TelemetryRecord> records;
+    std::vector<std::string> controllers;
+    if (!TelemetryLog::read (path, records, &controllers) || records.empty()) {
+        fprintf (stderr, "Sim: cannot replay %s\n", path);
+        return false;
+    }
+
+    for (size_t i = 0; i < controllers.size() && i < kMaxJoysticks; ++i)
+        s_state.controllers[i] = controllers[i];
+
+    s_state.events.clear();
+
+    const TelemetryRecord* previous = nullptr;
+    double time = 0;
+
+    for (const TelemetryRecord& record : records) {
+        bool gap = false;
+        if (previous) {
+            const double period = record.time - previous->time;
+            const int loops = std::max (1, (int) lround (period / Sim::kLoopPeriod));
+            if (loops > 1) {
+                addEvent (time + Sim::kLoopPeriod, Event::kMode, 0, 0, Sim::kDisabled);
+                gap = true;
+            }
+
+            time += loops * Sim::kLoopPeriod;
+        }
+
+        if (!previous || gap || previous->mode != record.mode)
+            addEvent (time, Event::kMode, 0, 0, record.mode);
+
+        for (int i = 0; i < TelemetryRecord::kJoysticks; ++i) {
+            for (int j = 0; j < TelemetryRecord::kAxes; ++j) {
+                if (!previous || previous->axes[i][j] != record.axes[i][j])
+                    addEvent (time, Event::kAxis, i, j, record.axes[i][j]);
+            }
+
+            const uint32_t changed = previous ? previous->buttons[i] ^ record.buttons[i] : ~0u;
+            for (int j = 1; j < kMaxButtons; ++j) {
+                if (changed & (1u << (j - 1)))
+                    addEvent (time, Event::kButton, i, j, (record.buttons[i] >> (j - 1)) & 1);
+            }
+        }
+
+        if (!previous || previous->range != record.range)
+            addEvent (time, Event::kSensor, 0, 0, record.range, kReplayRangeSensor);
+
+        previous = &record;
+    }
+
+    addEvent (time + Sim::kLoopPeriod, Event::kEnd, 0, 0, 0);
+    return true;
+}
+
+//===============================================================================
+// Sim::now
+//===============================================================================
+
+double Sim::now() {
+    return s_state.micros.load() * 1e-6;
+}
+
+//===============================================================================
+// Sim::mode
+//===============================================================================
+
+Sim::Mode Sim::mode() {
+    return s_state.mode;
+}
+
+//===============================================================================
+// Sim::running
+//===============================================================================
+
+bool Sim::running() {
+    return s_state.running;
+}
+
+//===============================================================================
+// Sim::attached
+//===============================================================================
+
+///
+/// The driver station is attached from the first loop, not when the robot
+/// program starts
+///
+bool Sim::attached() {
+    return s_state.attached;
+}
+
+//===============================================================================
+// Sim::controller
+//===============================================================================
+
+///
+/// Returns the name of the controller plugged in a port: the one named by
+/// the replayed log, by KZ_SIM_CONTROLLER, or an Xbox 360 controller
+///
+std::string Sim::controller (int port) {
+    if (port >= 0 && port < kMaxJoysticks && !s_state.controllers[port].empty())
+        return s_state.controllers[port];
+
+    const char* name = getenv ("KZ_SIM_CONTROLLER");
+    return name ? name : "Controller (XBOX 360 For Windows)";
+}
+
+//===============================================================================
+// Sim::axis
+//===============================================================================
+
+float Sim::axis (int port, int axis) {
+    if (port < 0 || port >= kMaxJoysticks || axis < 0 || axis >= kMaxAxes)
+        return 0;
+
+    return s_state.axes[port][axis];
+}
+
+//===============================================================================
+// Sim::button
+//===============================================================================
+
+bool Sim::button (int port, int button) {
+    if (port < 0 || port >= kMaxJoysticks || button < 1 || button >= kMaxButtons)
+        return false;
+
+    return s_state.buttons[port][button];
+}
+
+//===============================================================================
+// Sim::pov
+//===============================================================================
+
+int Sim::pov (int port) {
+    if (port < 0 || port >= kMaxJoysticks)
+        return -1;
+
+    return s_state.povs[port];
+}
+
+//===============================================================================
+// Sim::sensor
+//===============================================================================
+
+double Sim::sensor (const std::string& name, double fallback) {
+    std::map<std::string, double>::const_iterator it = s_state.sensors.find (name);
+    return it == s_state.sensors.end() ? fallback : it->second;
+}
+
+//===============================================================================
+// Sim::heading
+//===============================================================================
+
+///
+/// Returns the heading of the simulated robot, in degrees (counterclockwise)
+///
+double Sim::heading() {
+    return s_state.heading;
+}
+
+//===============================================================================
+// Sim::target
+//===============================================================================
+
+///
+/// Gives the bearing of the vision target as seen from the robot (in
+/// degrees, positive to the right) when a frame that arrives now was
+/// exposed, and the cache frame that shows it. Returns false if the script
+/// has not placed a target. Used by the camera threads.
+///
+bool Sim::target (double& bearing, int& frame) {
+    if (!s_state.hasTarget)
+        return false;
+
+    const uint32_t delay = (uint32_t) lround (kCameraLatency / kLoopPeriod);
+    const uint32_t count = s_state.headingCount;
+    const uint32_t loop = count > delay ? count - 1 - delay : 0;
+
+    bearing = s_state.pastHeadings[loop % kHeadingHistory] - s_state.targetBearing;
+    frame = s_state.cameraFrame;
+    return true;
+}
+
+//===============================================================================
+// Sim::pressureLow
+//===============================================================================
+
+///
+/// Returns true while the pressure switch of the tanks is closed
+///
+bool Sim::pressureLow() {
+    return s_state.pressureLow;
+}
+
+//===============================================================================
+// Sim::addOutput
+//===============================================================================
+
+///
+/// Records the given value in the log after every loop
+///
+void Sim::addOutput (const std::string& name, const float* value) {
+    s_state.outputs.push_back (std::make_pair (name, value));
+}
+
+//===============================================================================
+// Sim::removeOutput
+//===============================================================================
+
+void Sim::removeOutput (const float* value) {
+    std::vector<std::pair<std::string, const float*>>& outputs = s_state.outputs;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        if (outputs[i].second == value) {
+            outputs.erase (outputs.begin() + i);
+            return;
+        }
+    }
+}
+
+//===============================================================================
+// Sim::addBusFrame
+//===============================================================================
+
+void Sim::addBusFrame() {
+    ++s_state.busFrames;
+}
+
+//===============================================================================
+// Sim::addNotifier
+//===============================================================================
+
+void Sim::addNotifier (Notifier* notifier) {
+    s_state.notifiers.push_back (notifier);
+}
+
+//===============================================================================
+// Sim::removeNotifier
+//===============================================================================
+
+void Sim::removeNotifier (Notifier* notifier) {
+    std::vector<Notifier*>& notifiers = s_state.notifiers;
+    notifiers.erase (std::remove (notifiers.begin(), notifiers.end(), notifier),
+                     notifiers.end());
+}
+
+//===============================================================================
+// Sim::addTalon
+//===============================================================================
+
+void Sim::addTalon (CANTalon* talon) {
+    s_state.talons.push_back (talon);
+}
+
+//===============================================================================
+// Sim::removeTalon
+//===============================================================================
+
+void Sim::removeTalon (CANTalon* talon) {
+    std::vector<CANTalon*>& talons = s_state.talons;
+    talons.erase (std::remove (talons.begin(), talons.end(), talon), talons.end());
+}
+
+//===============================================================================
+// Sim::addCompressor
+//===============================================================================
+
+void Sim::addCompressor (Compressor* compressor) {
+    s_state.compressors.push_back (compressor);
+}
+
+//===============================================================================
+// Sim::removeCompressor
+//===============================================================================
+
+void Sim::removeCompressor (Compressor* compressor) {
+    std::vector<Compressor*>& compressors = s_state.compressors;
+    compressors.erase (std::remove (compressors.begin(), compressors.end(), compressor),
+                       compressors.end());
+}
+
+//===============================================================================
+// Sim::addPneumaticsCommand
+//===============================================================================
+
+void Sim::addPneumaticsCommand() {
+    ++s_state.pneumaticsCommands;
+}
+
+//===============================================================================
+// Sim::movePiston
+//===============================================================================
+
+void Sim::movePiston() {
+    s_state.pressure = std::max (0.0, s_state.pressure - kPistonAir);
+}
+
+//===============================================================================
+// sidePosition
+//===============================================================================
+
+///
+/// Returns the mean position (in motor rotations) of the given Talons
+///
+template <size_t N>
+static double sidePosition (const int (&ids)[N]) {
+    double total = 0;
+    for (CANTalon* talon : s_state.talons) {
+        if (std::find (ids, ids + N, talon->GetDeviceID()) != ids + N)
+            total += talon->GetMotorPosition();
+    }
+
+    return total / N;
+}
+
+//===============================================================================
+// updateDrivetrain
+//===============================================================================
+
+///
+/// Brings the Talons up to the current time and turns the travel of the
+/// wheels into the heading of the robot, the distance it drove (forward
+/// is positive) and its position (along an arc since the previous loop, x
+/// forward and y to the left of the initial heading). The right motors are
+/// reversed, so both sides turn the robot clockwise when they go forward.
+///
+static void updateDrivetrain() {
+    for (CANTalon* talon : s_state.talons)
+        talon->Update();
+
+    const double inchesPerRotation = M_PI * Sim::kWheelDiameter / Sim::kGearRatio;
+    const double left = sidePosition (Sim::kLeftTalons) * inchesPerRotation;
+    const double right = -sidePosition (Sim::kRightTalons) * inchesPerRotation;
+    const double heading = (right - left) * Sim::kTurnEfficiency / Sim::kTrackWidth;
+
+    const double distance = (left + right) / 2;
+    const double middle = (heading + s_state.heading * M_PI / 180) / 2;
+    s_state.x += (distance - s_state.distance) * cos (middle);
+    s_state.y += (distance - s_state.distance) * sin (middle);
+    s_state.distance = distance;
+    s_state.xOutput = (float) s_state.x;
+    s_state.yOutput = (float) s_state.y;
+    s_state.distanceOutput = (float) distance;
+
+    s_state.heading = heading * 180 / M_PI;
+    s_state.pastHeadings[s_state.headingCount % kHeadingHistory] = s_state.heading.load();
+    ++s_state.headingCount;
+    s_state.headingOutput = (float) s_state.heading;
+    s_state.headings.push_back (std::make_pair (Sim::now(), s_state.heading.load()));
+}
+
+//===============================================================================
+// Sim::busVoltage
+//===============================================================================
+
+///
+/// Returns the voltage of the battery with the current outputs of the Talons
+/// and the compressor. The currents of the motors depend on the voltage,
+/// which depends on them:
+///
+///     V = V0 - R (I + sum (d * Is * (d * V / V0 - s)))
+///
+double Sim::busVoltage() {
+    double current = Sim::kBaseCurrent;
+    for (Compressor* compressor : s_state.compressors)
+        current += compressor->GetCompressorCurrent();
+
+    double squares = 0;
+    double products = 0;
+    for (CANTalon* talon : s_state.talons) {
+        const double output = talon->GetAppliedOutput();
+        squares += output * output;
+        products += output * talon->GetSpeedRatio();
+    }
+
+    const double resistance = Sim::kBatteryResistance * CANTalon::kStallCurrent;
+    return (Sim::kBatteryVoltage - Sim::kBatteryResistance * current + resistance * products) /
+           (1 + resistance * squares / Sim::kBatteryVoltage);
+}
+
+//===============================================================================
+// sampleVoltage
+//===============================================================================
+
+///
+/// Measures the voltage of the battery, after every cycle of the control
+/// loop and at the end of every loop, and the time it spends under the
+/// brownout voltage. The braking current of the Talons set to coast is
+/// measured at the same time: they must let their motors spin down.
+///
+static void sampleVoltage() {
+    const double time = Sim::now();
+    if (s_state.voltage < Sim::kBrownoutVoltage)
+        s_state.brownoutTime += time - s_state.sampleTime;
+
+    s_state.voltage = Sim::busVoltage();
+    s_state.sampleTime = time;
+    s_state.minVoltage = std::min (s_state.minVoltage, s_state.voltage);
+
+    for (CANTalon* talon : s_state.talons) {
+        if (talon->GetNeutralCoast())
+            s_state.coastBraking = std::max (s_state.coastBraking, talon->GetBrakingCurrent());
+    }
+}
+
+//===============================================================================
+// updatePower
+//===============================================================================
+
+///
+/// Fills the tanks while the compressor runs (the pressure switch has some
+/// hysteresis) and measures the voltage of the battery at the end of the
+/// loop
+///
+static void updatePower() {
+    bool compressing = false;
+    for (Compressor* compressor : s_state.compressors)
+        compressing |= compressor->Enabled();
+
+    if (compressing)
+        s_state.pressure += Sim::kFillRate * Sim::kLoopPeriod;
+
+    if (s_state.pressure >= Sim::kSwitchHigh)
+        s_state.pressureLow = false;
+    else if (s_state.pressure < Sim::kSwitchLow)
+        s_state.pressureLow = true;
+
+    for (Compressor* compressor : s_state.compressors)
+        compressor->Update();
+
+    sampleVoltage();
+    s_state.pressureOutput = (float) s_state.pressure;
+    s_state.voltageOutput = (float) s_state.voltage;
+}
+
+//===============================================================================
+// reportAims
+//===============================================================================
+
+///
+/// Prints how each change of the target bearing was followed: the time
+/// until the heading stayed within kAlignTolerance of its final value, and
+/// how far it went past that value
+///
+static void reportAims() {
+    const std::vector<std::pair<double, double>>& headings = s_state.headings;
+
+    for (size_t i = 0; i < s_state.aims.size(); ++i) {
+        const size_t first = s_state.aims[i];
+        const size_t last = i + 1 < s_state.aims.size() ? s_state.aims[i + 1] : headings.size();
+        if (last <= first + 1)
+            continue;
+
+        const double start = headings[first].first;
+        const double from = headings[first].second;
+        const double to = headings[last - 1].second;
+        const double direction = to >= from ? 1 : -1;
+
+        double aligned = start;
+        double overshoot = 0;
+        for (size_t j = first; j < last; ++j) {
+            if (fabs (headings[j].second - to) > Sim::kAlignTolerance)
+                aligned = headings[std::min (j + 1, last - 1)].first;
+
+            overshoot = std::max (overshoot, (headings[j].second - to) * direction);
+        }
+
+        fprintf (stderr, "Sim: aim at %.2f s, heading %.1f -> %.1f deg, "
+                 "aligned after %.2f s, overshoot %.2f deg\n",
+                 start, from, to, aligned - start, overshoot);
+    }
+}
+
+//===============================================================================
+// pace
+//===============================================================================
+
+///
+/// Waits until the wall clock reaches the simulated time, when the
+/// simulation is paced
+///
+static void pace() {
+    if (s_state.speed > 0) {
+        typedef std::chrono::steady_clock::duration Duration;
+        std::chrono::duration<double> wall (Sim::now() / s_state.speed);
+        std::this_thread::sleep_until (s_state.wallStart +
+                                       std::chrono::duration_cast<Duration> (wall));
+    }
+}
+
+//===============================================================================
+// runNotifiers
+//===============================================================================
+
+///
+/// Calls the notifiers that are due before the given time, in order. The
+/// clock is set to the time of each notifier while its handler runs (and
+/// the handler is called at that time when the simulation is paced).
+/// Returns the time spent in the handlers, in microseconds.
+///
+static double runNotifiers (int64_t end) {
+    std::chrono::duration<double, std::micro> elapsed (0);
+
+    for (;;) {
+        Notifier* next = nullptr;
+        for (Notifier* notifier : s_state.notifiers) {
+            if (notifier->IsActive() && (!next || notifier->GetNextTime() < next->GetNextTime()))
+                next = notifier;
+        }
+
+        if (!next)
+            return elapsed.count();
+
+        const int64_t time = llround (next->GetNextTime() * 1e6);
+        if (time > end)
+            return elapsed.count();
+
+        s_state.micros = std::max (s_state.micros.load(), time);
+        pace();
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Sim::setLoop (Sim::kControlLoop);
+        next->Fire();
+        Sim::setLoop (Sim::kNoLoop);
+        sampleVoltage();
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+}
+
+//===============================================================================
+// Sim::begin
+//===============================================================================
+
+///
+/// Reads the configuration and the script, returns false on error
+///
+bool Sim::begin() {
+    if (const char* replay = getenv ("KZ_SIM_REPLAY")) {
+        if (!loadReplay (replay))
+            return false;
+    }
+
+    else if (!loadScript (getenv ("KZ_SIM_SCRIPT")))
+        return false;
+
+    if (const char* speed = getenv ("KZ_SIM_SPEED"))
+        s_state.speed = atof (speed);
+
+    if (const char* path = getenv ("KZ_SIM_LOG")) {
+        s_state.log = fopen (path, "w");
+        if (!s_state.log) {
+            fprintf (stderr, "Sim: cannot write %s\n", path);
+            return false;
+        }
+    }
+
+    s_state.loopTimes.reserve (1 << 16);
+    s_state.headings.reserve (1 << 16);
+    s_state.headings.push_back (std::make_pair (0.0, 0.0));
+    addOutput ("Heading", &s_state.headingOutput);
+    addOutput ("Distance", &s_state.distanceOutput);
+    addOutput ("X", &s_state.xOutput);
+    addOutput ("Y", &s_state.yOutput);
+    addOutput ("Pressure", &s_state.pressureOutput);
+    addOutput ("Battery", &s_state.voltageOutput);
+
+    s_state.wallStart = std::chrono::steady_clock::now();
+    s_state.running = true;
+    return true;
+}
+
+//===============================================================================
+// Sim::step
+//===============================================================================
+
+///
+/// Applies the events of the current time, returns false once the script
+/// has ended
+///
+bool Sim::step() {
+    const double time = now() + 1e-9;
+    std::vector<Event>& events = s_state.events;
+
+    while (s_state.nextEvent < events.size() && events[s_state.nextEvent].time <= time) {
+        const Event& event = events[s_state.nextEvent++];
+
+        switch (event.type) {
+            case Event::kMode:
+                s_state.mode = (Mode) (int) event.value;
+                break;
+            case Event::kAxis:
+                s_state.axes[event.port][event.index] = (float) event.value;
+                break;
+            case Event::kButton:
+                s_state.buttons[event.port][event.index] = event.value != 0;
+                break;
+            case Event::kPov:
+                s_state.povs[event.port] = (int) event.value;
+                break;
+            case Event::kSensor:
+                if (event.name == kTargetSensor && sensor (event.name, NAN) != event.value)
+                    s_state.aims.push_back (s_state.headings.size() - 1);
+
+                s_state.sensors[event.name] = event.value;
+                break;
+            case Event::kEnd:
+                return false;
+        }
+    }
+
+    s_state.targetBearing = sensor (kTargetSensor, 0);
+    s_state.cameraFrame = (int) sensor (kFrameSensor, -1);
+    s_state.hasTarget = s_state.sensors.count (kTargetSensor) > 0;
+
+    if (s_state.nextEvent >= events.size())
+        return false;
+
+    s_state.attached = true;
+    s_state.loopStart = std::chrono::steady_clock::now();
+    setLoop (kPacketLoop);
+    return true;
+}
+
+//===============================================================================
+// Sim::record
+//===============================================================================
+
+///
+/// Ends a loop: logs the outputs, advances the clock (waiting if the
+/// simulation is paced) and measures the time spent in the robot program,
+/// including the notifiers that ran until the next loop
+///
+void Sim::record() {
+    setLoop (kNoLoop);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::micro> elapsed = end - s_state.loopStart;
+    s_state.enabledLoops += s_state.mode != kDisabled;
+
+    if (FILE* log = s_state.log) {
+        if (!s_state.headerWritten) {
+            fprintf (log, "time,mode");
+            for (const auto& output : s_state.outputs)
+                fprintf (log, ",%s", output.first.c_str());
+
+            fprintf (log, "\n");
+            s_state.headerWritten = true;
+        }
+
+        fprintf (log, "%.3f,%d", now(), (int) s_state.mode);
+        for (const auto& output : s_state.outputs)
+            fprintf (log, ",%.4f", *output.second + 0.0f);
+
+        fprintf (log, "\n");
+    }
+
+    const int64_t next = s_state.micros + (int64_t) (kLoopPeriod * 1e6);
+    s_state.loopTimes.push_back (elapsed.count() + runNotifiers (next));
+    s_state.micros = next;
+    updateDrivetrain();
+    updatePower();
+    pace();
+}
+
+//===============================================================================
+// Sim::finish
+//===============================================================================
+
+///
+/// Stops the simulation and prints the time spent in the robot program,
+/// returns false if the robot loop allocated memory
+///
+bool Sim::finish() {
+    s_state.running = false;
+
+    if (s_state.log)
+        fclose (s_state.log);
+
+    s_state.log = nullptr;
+
+    std::vector<double>& times = s_state.loopTimes;
+    if (times.empty())
+        return true;
+
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - s_state.wallStart;
+    double total = 0;
+    for (double time : times)
+        total += time;
+
+    std::sort (times.begin(), times.end());
+    fprintf (stderr, "Sim: %zu loops, %.1f s simulated in %.2f s (%.1fx real time)\n",
+             times.size(), now(), wall.count(), now() / wall.count());
+    fprintf (stderr, "Sim: robot code p50 %.1f us, p99 %.1f us, max %.1f us, mean %.1f us\n",
+             times[times.size() / 2], times[(times.size() - 1) * 99 / 100], times.back(),
+             total / times.size());
+
+    reportAims();
+
+    if (s_state.enabledLoops > 0) {
+        const double perLoop = (double) s_state.busFrames / s_state.enabledLoops;
+        fprintf (stderr, "Sim: %llu CAN frames, %.2f per enabled loop (%.2f%% of the bus)\n",
+                 (unsigned long long) s_state.busFrames, perLoop,
+                 100 * perLoop * kBusFrameBits / (kBusBitRate * kLoopPeriod));
+    }
+
+    fprintf (stderr, "Sim: %llu pneumatics commands, %.0f psi at the end\n",
+             (unsigned long long) s_state.pneumaticsCommands, s_state.pressure);
+    fprintf (stderr, "Sim: battery at %.2f V or more, %.2f s below %.1f V\n",
+             s_state.minVoltage, s_state.brownoutTime, kBrownoutVoltage);
+    fprintf (stderr, "Sim: %.1f A of braking current at most in the Talons set to coast\n",
+             s_state.coastBraking);
+
+    const uint64_t allocations = loopAllocations (kControlLoop);
+    fprintf (stderr, "Sim: %llu heap allocations in the control loop, %llu in the packet loop\n",
+             (unsigned long long) allocations,
+             (unsigned long long) loopAllocations (kPacketLoop));
+
+    return allocations == 0;
+}
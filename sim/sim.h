@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+class CANTalon;
+class Compressor;
+class Notifier;
+
+///
+/// State of the simulated robot, shared by the WPILib stand-ins.
+///
+/// The simulation is configured with environment variables:
+///
+///     KZ_SIM_SCRIPT   Script with the driver station inputs (see below),
+///                     a disabled/autonomous/teleop match without inputs is
+///                     used when it is not set
+///     KZ_SIM_LOG      CSV file where the actuator outputs are recorded
+///                     after every loop
+///     KZ_SIM_SPEED    Speed of the simulated clock: 1 is real time (the
+///                     default), 10 is ten times faster, 0 is as fast as
+///                     possible
+///     KZ_SIM_FRAMES   Frame cache (see tools/corpus-pack) played by the
+///                     simulated USB cameras
+///     KZ_SIM_REPLAY   Telemetry log (see TelemetryRecorder) whose inputs
+///                     are played instead of a script, with the controllers
+///                     named in its header
+///     KZ_SIM_CONTROLLER
+///                     Name of the controllers reported by the driver
+///                     station (an Xbox 360 controller by default)
+///
+/// Scripts have one event per line, starting with the time (in seconds) at
+/// which the event happens:
+///
+///     0.0   mode disabled
+///     1.0   mode autonomous
+///     16.0  mode teleop
+///     16.0  axis 0 1 -0.8         (joystick 0, axis 1 set to -0.8)
+///     17.5  button 1 4 1          (joystick 1, button 4 pressed)
+///     18.0  sensor Ultrasonic1 80 (value read by a sensor)
+///     20.0  end
+///
+/// Lines starting with # are ignored.
+///
+/// The heading of the robot, the distance it drove and its position (X and
+/// Y, logged with the outputs) are integrated from the positions of the
+/// drive Talons. Two sensors place a vision target around the robot:
+///
+///     TargetBearing   Direction of the target, in degrees (counterclockwise
+///                     from the initial heading of the robot)
+///     CameraFrame     Index of the cache frame that shows the target, it
+///                     is shifted horizontally to match the heading
+///
+/// Every time TargetBearing changes, the simulation starts measuring how
+/// long the robot takes to settle on its new heading, and by how much it
+/// goes past it.
+///
+/// The pressure of the tanks (Pressure) and the voltage of the battery
+/// (Battery) are also logged. The simulation prints the number of commands
+/// sent to the compressor and the solenoids, the lowest battery voltage and
+/// the time spent below the brownout voltage. It also prints the highest
+/// braking current of the Talons set to coast (such as the flywheels), which
+/// must be 0: they must not brake their motors when the output is released.
+///
+/// The control cycles of the robot must not allocate memory: the operator
+/// new of the simulation counts the allocations made by each loop of the
+/// robot program, and the simulation fails if the control loop (the
+/// notifiers) made any. The packet loop (the Periodic functions) writes the
+/// dashboard, which allocates, so its allocations are only printed.
+///
+namespace Sim {
+enum Mode {
+    kDisabled,
+    kAutonomous,
+    kTeleop,
+    kTest,
+};
+
+enum Loop {
+    kNoLoop,
+    kPacketLoop,
+    kControlLoop,
+    kLoops,
+};
+
+///
+/// Duration of a loop of the robot program (a driver station packet)
+///
+const double kLoopPeriod = 0.020;
+
+///
+/// Approximate size of a CAN frame with an 8-byte payload, including the
+/// stuff bits, and the bit rate of the roboRIO CAN bus
+///
+const int kBusFrameBits = 128;
+const double kBusBitRate = 1e6;
+
+///
+/// Drivetrain of the robot: the drive Talons, the reduction of their
+/// gearboxes, the wheel diameter and the track width (in inches). Turning in
+/// place scrubs the wheels, so only a part of their travel turns the robot.
+///
+const int kLeftTalons[] = { 2, 4 };
+const int kRightTalons[] = { 3, 5 };
+const double kGearRatio = 10.71;
+const double kWheelDiameter = 11;
+const double kTrackWidth = 24;
+const double kTurnEfficiency = 0.6;
+
+///
+/// Horizontal field of view of the simulated camera (in degrees), the time
+/// between the exposure of a frame and its arrival (in seconds), and the
+/// heading error that counts as aligned with the target
+///
+const double kCameraFOV = 60;
+const double kCameraLatency = 0.06;
+const double kAlignTolerance = 1;
+
+///
+/// Pneumatics of the robot: the tanks are not full when the match starts
+/// (pressures are in psi), the compressor fills them at kFillRate psi per
+/// second while it runs and each movement of a piston uses kPistonAir. The
+/// pressure switch opens at kSwitchHigh and closes again below kSwitchLow.
+///
+const double kInitialPressure = 60;
+const double kFillRate = 1.5;
+const double kPistonAir = 8;
+const double kSwitchHigh = 120;
+const double kSwitchLow = 95;
+const double kCompressorCurrent = 10;
+
+///
+/// Electrical system: the battery is a voltage source with an internal
+/// resistance (including the wiring, in ohms) that supplies the Talons, the
+/// compressor and kBaseCurrent amps for the controllers. A motor draws its
+/// stall current (see CANTalon) when the voltage applied to it is the full
+/// kBatteryVoltage and it does not turn, and the Talon draws that current
+/// from the battery during the duty cycle of its output. The roboRIO browns
+/// out below kBrownoutVoltage. The voltage does not change the speed of the
+/// simulated motors. The PDP stand-in measures busVoltage().
+///
+const double kBatteryVoltage = 12.7;
+const double kBatteryResistance = 0.012;
+const double kBaseCurrent = 3;
+const double kBrownoutVoltage = 7;
+
+double now();
+Mode mode();
+bool running();
+bool attached();
+
+std::string controller (int port);
+float axis (int port, int axis);
+bool button (int port, int button);
+int pov (int port);
+double sensor (const std::string& name, double fallback);
+double heading();
+bool target (double& bearing, int& frame);
+bool pressureLow();
+double busVoltage();
+
+void addOutput (const std::string& name, const float* value);
+void removeOutput (const float* value);
+void addBusFrame();
+void addNotifier (Notifier* notifier);
+void removeNotifier (Notifier* notifier);
+void addTalon (CANTalon* talon);
+void removeTalon (CANTalon* talon);
+void addCompressor (Compressor* compressor);
+void removeCompressor (Compressor* compressor);
+void addPneumaticsCommand();
+void movePiston();
+void setLoop (Loop loop);
+uint64_t loopAllocations (Loop loop);
+
+bool begin();
+bool step();
+void record();
+bool finish();
+}
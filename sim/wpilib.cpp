@@ -0,0 +1,895 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "WPILib.h"
+#include "sim.h"
+
+#include <math.h>
+#include <map>
+#include <mutex>
+#include <thread>
+
+//===============================================================================
+// HALInitialize
+//===============================================================================
+
+int HALInitialize (int mode) {
+    (void) mode;
+    return 1;
+}
+
+//===============================================================================
+// HALReport
+//===============================================================================
+
+int HALReport (uint8_t resource, uint8_t instanceNumber, uint8_t context,
+               const char* feature) {
+    (void) resource;
+    (void) instanceNumber;
+    (void) context;
+    (void) feature;
+    return 0;
+}
+
+//===============================================================================
+// RobotBase
+//===============================================================================
+
+bool RobotBase::IsEnabled() const {
+    return Sim::mode() != Sim::kDisabled;
+}
+
+bool RobotBase::IsDisabled() const {
+    return Sim::mode() == Sim::kDisabled;
+}
+
+bool RobotBase::IsAutonomous() const {
+    return Sim::mode() == Sim::kAutonomous;
+}
+
+bool RobotBase::IsOperatorControl() const {
+    return Sim::mode() == Sim::kTeleop;
+}
+
+bool RobotBase::IsTest() const {
+    return Sim::mode() == Sim::kTest;
+}
+
+void RobotBase::robotSetup (RobotBase* robot) {
+    robot->StartCompetition();
+}
+
+//===============================================================================
+// IterativeRobot::StartCompetition
+//===============================================================================
+
+///
+/// Same sequence as the IterativeRobot of WPILib: the Init function of a mode
+/// is called when the mode changes, then its Periodic function is called once
+/// per driver station packet (every 20 ms of simulated time)
+///
+void IterativeRobot::StartCompetition() {
+    if (!Sim::begin())
+        exit (EXIT_FAILURE);
+
+    RobotInit();
+
+    bool initialized = false;
+    Sim::Mode current = Sim::kDisabled;
+
+    while (Sim::step()) {
+        const Sim::Mode mode = Sim::mode();
+
+        if (!initialized || mode != current) {
+            switch (mode) {
+                case Sim::kDisabled:
+                    DisabledInit();
+                    break;
+                case Sim::kAutonomous:
+                    AutonomousInit();
+                    break;
+                case Sim::kTeleop:
+                    TeleopInit();
+                    break;
+                case Sim::kTest:
+                    TestInit();
+                    break;
+            }
+
+            initialized = true;
+            current = mode;
+        }
+
+        switch (mode) {
+            case Sim::kDisabled:
+                DisabledPeriodic();
+                break;
+            case Sim::kAutonomous:
+                AutonomousPeriodic();
+                break;
+            case Sim::kTeleop:
+                TeleopPeriodic();
+                break;
+            case Sim::kTest:
+                TestPeriodic();
+                break;
+        }
+
+        Sim::record();
+    }
+
+    if (!Sim::finish())
+        exit (EXIT_FAILURE);
+}
+
+//===============================================================================
+// Timer
+//===============================================================================
+
+Timer::Timer() : m_startTime (Sim::now()), m_accumulatedTime (0), m_running (false) {}
+
+double Timer::Get() const {
+    return m_accumulatedTime + (m_running ? Sim::now() - m_startTime : 0);
+}
+
+void Timer::Reset() {
+    m_accumulatedTime = 0;
+    m_startTime = Sim::now();
+}
+
+void Timer::Start() {
+    if (!m_running) {
+        m_startTime = Sim::now();
+        m_running = true;
+    }
+}
+
+void Timer::Stop() {
+    m_accumulatedTime = Get();
+    m_running = false;
+}
+
+bool Timer::HasPeriodPassed (double period) {
+    if (Get() > period) {
+        m_startTime += period;
+        return true;
+    }
+
+    return false;
+}
+
+double Timer::GetFPGATimestamp() {
+    return Sim::now();
+}
+
+//===============================================================================
+// Wait
+//===============================================================================
+
+///
+/// Waits until the simulated clock (which is advanced by the robot loop)
+/// has moved forward by the given time
+///
+void Wait (double seconds) {
+    const double end = Sim::now() + seconds;
+    while (Sim::running() && Sim::now() < end)
+        std::this_thread::sleep_for (std::chrono::milliseconds (1));
+}
+
+//===============================================================================
+// Notifier
+//===============================================================================
+
+Notifier::Notifier (TimerEventHandler handler) :
+    m_handler (handler),
+    m_period (0),
+    m_next (0),
+    m_periodic (false),
+    m_active (false) {
+    Sim::addNotifier (this);
+}
+
+Notifier::~Notifier() {
+    Sim::removeNotifier (this);
+}
+
+void Notifier::StartSingle (double delay) {
+    m_next = Sim::now() + delay;
+    m_periodic = false;
+    m_active = true;
+}
+
+void Notifier::StartPeriodic (double period) {
+    m_period = period;
+    m_next = Sim::now() + period;
+    m_periodic = period > 0;
+    m_active = m_periodic;
+}
+
+void Notifier::Stop() {
+    m_active = false;
+}
+
+bool Notifier::IsActive() const {
+    return m_active;
+}
+
+double Notifier::GetNextTime() const {
+    return m_next;
+}
+
+void Notifier::Fire() {
+    m_active = m_periodic;
+    m_next += m_period;
+    m_handler();
+}
+
+//===============================================================================
+// Joystick
+//===============================================================================
+
+Joystick::Joystick (uint32_t port) : m_port (port) {}
+
+float Joystick::GetX() const {
+    return GetRawAxis (0);
+}
+
+float Joystick::GetY() const {
+    return GetRawAxis (1);
+}
+
+float Joystick::GetRawAxis (uint32_t axis) const {
+    return Sim::axis (m_port, axis);
+}
+
+bool Joystick::GetRawButton (uint32_t button) const {
+    return Sim::button (m_port, button);
+}
+
+int Joystick::GetPOV (uint32_t pov) const {
+    return pov == 0 ? Sim::pov (m_port) : -1;
+}
+
+int Joystick::GetAxisCount() const {
+    return 6;
+}
+
+int Joystick::GetButtonCount() const {
+    return 10;
+}
+
+//===============================================================================
+// DriverStation
+//===============================================================================
+
+DriverStation& DriverStation::GetInstance() {
+    static DriverStation instance;
+    return instance;
+}
+
+float DriverStation::GetStickAxis (uint32_t stick, uint32_t axis) {
+    return Sim::axis (stick, axis);
+}
+
+int DriverStation::GetStickPOV (uint32_t stick, uint32_t pov) {
+    return pov == 0 ? Sim::pov (stick) : -1;
+}
+
+uint32_t DriverStation::GetStickButtons (uint32_t stick) const {
+    uint32_t buttons = 0;
+    for (int i = 0; i < 32; ++i)
+        buttons |= (uint32_t) Sim::button (stick, i + 1) << i;
+
+    return buttons;
+}
+
+///
+/// The names are empty until the driver station is attached (see
+/// Sim::controller)
+///
+std::string DriverStation::GetJoystickName (uint32_t stick) const {
+    if (!Sim::attached())
+        return std::string();
+
+    return Sim::controller (stick);
+}
+
+bool DriverStation::IsDSAttached() const {
+    return Sim::attached();
+}
+
+//===============================================================================
+// SmartDashboard
+//===============================================================================
+
+///
+/// Like NetworkTables, the values are written under a lock, from any thread
+///
+static std::mutex s_mutex;
+static std::map<std::string, double> s_numbers;
+static std::map<std::string, std::string> s_strings;
+
+void SmartDashboard::PutNumber (const std::string& key, double value) {
+    std::lock_guard<std::mutex> lock (s_mutex);
+    s_numbers[key] = value;
+}
+
+void SmartDashboard::PutBoolean (const std::string& key, bool value) {
+    PutNumber (key, value);
+}
+
+void SmartDashboard::PutString (const std::string& key, const std::string& value) {
+    std::lock_guard<std::mutex> lock (s_mutex);
+    s_strings[key] = value;
+}
+
+double SmartDashboard::GetNumber (const std::string& key, double defaultValue) {
+    std::lock_guard<std::mutex> lock (s_mutex);
+    std::map<std::string, double>::const_iterator it = s_numbers.find (key);
+    return it == s_numbers.end() ? defaultValue : it->second;
+}
+
+bool SmartDashboard::GetBoolean (const std::string& key, bool defaultValue) {
+    return GetNumber (key, defaultValue) != 0;
+}
+
+std::string SmartDashboard::GetString (const std::string& key,
+                                       const std::string& defaultValue) {
+    std::lock_guard<std::mutex> lock (s_mutex);
+    std::map<std::string, std::string>::const_iterator it = s_strings.find (key);
+    return it == s_strings.end() ? defaultValue : it->second;
+}
+
+//===============================================================================
+// SpeedController
+//===============================================================================
+
+void SpeedController::StopMotor() {
+    Disable();
+}
+
+//===============================================================================
+// SimSpeedController
+//===============================================================================
+
+SimSpeedController::SimSpeedController (const std::string& name) :
+    m_output (0),
+    m_inverted (false),
+    m_safetyEnabled (true) {
+    Sim::addOutput (name, &m_output);
+}
+
+SimSpeedController::~SimSpeedController() {
+    Sim::removeOutput (&m_output);
+}
+
+void SimSpeedController::Set (float speed, uint8_t syncGroup) {
+    (void) syncGroup;
+    speed = fmaxf (-1, fminf (1, speed));
+    m_output = m_inverted ? -speed : speed;
+}
+
+float SimSpeedController::Get() const {
+    return m_output;
+}
+
+void SimSpeedController::SetInverted (bool isInverted) {
+    m_inverted = isInverted;
+}
+
+bool SimSpeedController::GetInverted() const {
+    return m_inverted;
+}
+
+void SimSpeedController::Disable() {
+    m_output = 0;
+}
+
+void SimSpeedController::PIDWrite (float output) {
+    Set (output);
+}
+
+void SimSpeedController::SetSafetyEnabled (bool enabled) {
+    m_safetyEnabled = enabled;
+}
+
+bool SimSpeedController::IsSafetyEnabled() const {
+    return m_safetyEnabled;
+}
+
+void SimSpeedController::SetExpiration (double timeout) {
+    (void) timeout;
+}
+
+Talon::Talon (uint32_t channel) :
+    SimSpeedController ("PWM" + std::to_string (channel)) {}
+
+Victor::Victor (uint32_t channel) :
+    SimSpeedController ("PWM" + std::to_string (channel)) {}
+
+CANTalon::CANTalon (int deviceNumber) :
+    CANSpeedController ("CAN" + std::to_string (deviceNumber)),
+    m_deviceNumber (deviceNumber),
+    m_mode (kPercentVbus),
+    m_codesPerRev (0),
+    m_reverseSensor (false),
+    m_p (0), m_i (0), m_d (0), m_f (0),
+    m_peakForward (1),
+    m_peakReverse (-1),
+    m_coast (false),
+    m_integral (0),
+    m_lastError (0),
+    m_demand (0),
+    m_applied (0),
+    m_speed (0),
+    m_position (0),
+    m_lastUpdate (Sim::now()) {
+    Sim::addTalon (this);
+}
+
+CANTalon::~CANTalon() {
+    Sim::removeTalon (this);
+}
+
+void CANTalon::Set (float value, uint8_t syncGroup) {
+    Update();
+    Sim::addBusFrame();
+
+    if (m_mode == kPercentVbus) {
+        SimSpeedController::Set (value, syncGroup);
+        m_demand = m_output;
+    }
+
+    else {
+        m_output = value;
+        m_demand = m_inverted ? -value : value;
+    }
+}
+
+void CANTalon::Disable() {
+    Update();
+    SimSpeedController::Disable();
+    Sim::addBusFrame();
+    m_demand = 0;
+}
+
+void CANTalon::SetControlMode (ControlMode mode) {
+    Update();
+    m_mode = mode;
+    m_demand = 0;
+    m_integral = 0;
+}
+
+CANSpeedController::ControlMode CANTalon::GetControlMode() const {
+    return m_mode;
+}
+
+void CANTalon::SetFeedbackDevice (FeedbackDevice device) {
+    (void) device;
+}
+
+void CANTalon::ConfigEncoderCodesPerRev (uint16_t codesPerRev) {
+    m_codesPerRev = codesPerRev;
+}
+
+void CANTalon::SetSensorDirection (bool reverseSensor) {
+    m_reverseSensor = reverseSensor;
+}
+
+void CANTalon::SetPID (double p, double i, double d, double f) {
+    m_p = p;
+    m_i = i;
+    m_d = d;
+    m_f = f;
+}
+
+///
+/// The peak output voltages are stored as an output (the default peak of
+/// the Talon, 12 V, is the full output)
+///
+void CANTalon::ConfigPeakOutputVoltage (double forwardVoltage, double reverseVoltage) {
+    Update();
+    Sim::addBusFrame();
+    m_peakForward = fmin (1, forwardVoltage / kNominalVoltage);
+    m_peakReverse = fmax (-1, reverseVoltage / kNominalVoltage);
+}
+
+void CANTalon::ConfigNeutralMode (NeutralMode mode) {
+    Update();
+    Sim::addBusFrame();
+    m_coast = mode == kNeutralMode_Coast;
+}
+
+double CANTalon::GetSpeed() const {
+    Update();
+    return m_reverseSensor ? -m_speed : m_speed;
+}
+
+double CANTalon::GetPosition() const {
+    Update();
+    return m_reverseSensor ? -m_position : m_position;
+}
+
+void CANTalon::SetPosition (double position) {
+    Update();
+    m_position = m_reverseSensor ? -position : position;
+}
+
+///
+/// Current of the motor: its stall current, scaled by the difference between
+/// the voltage applied by the Talon and the back-EMF of its speed
+///
+double CANTalon::GetOutputCurrent() const {
+    Update();
+    if (IsCoasting())
+        return 0;
+
+    const double voltage = m_applied * Sim::busVoltage() / Sim::kBatteryVoltage;
+    return kStallCurrent * fabs (voltage - GetSpeedRatio());
+}
+
+///
+/// Output of the Talon (from -1 to 1), as applied by its closed loop
+///
+double CANTalon::GetAppliedOutput() const {
+    Update();
+    return m_applied;
+}
+
+///
+/// Speed of the motor, from -1 to 1 (its free speed)
+///
+double CANTalon::GetSpeedRatio() const {
+    return m_speed / kFreeSpeed;
+}
+
+///
+/// Current of the motor while the output of the Talon is neutral or opposes
+/// the speed of the motor (the motor is used as a brake), 0 otherwise
+///
+double CANTalon::GetBrakingCurrent() const {
+    const double ratio = GetSpeedRatio();
+    return ratio != 0 && m_applied * ratio <= 0 ? GetOutputCurrent() : 0;
+}
+
+bool CANTalon::GetNeutralCoast() const {
+    return m_coast;
+}
+
+///
+/// True when the Talon is set to coast and its output is neutral, the motor
+/// is then disconnected
+///
+bool CANTalon::IsCoasting() const {
+    return m_coast && m_applied == 0;
+}
+
+int CANTalon::GetDeviceID() const {
+    return m_deviceNumber;
+}
+
+double CANTalon::GetMotorPosition() const {
+    return m_position;
+}
+
+int CANTalon::GetClosedLoopError() const {
+    Update();
+    return m_mode == kSpeed ? (int) nativeUnits (m_demand - m_speed) : 0;
+}
+
+///
+/// Converts a speed in RPM to encoder edges per 100 ms, the unit used by the
+/// closed loop of the Talon
+///
+double CANTalon::nativeUnits (double rpm) const {
+    return rpm * m_codesPerRev * 4 / 600;
+}
+
+///
+/// Runs the closed loop (at 1 kHz, like the Talon) and the motor model up
+/// to the current time
+///
+void CANTalon::Update() const {
+    const double kStep = 0.001;
+
+    while (m_lastUpdate + kStep <= Sim::now() + 1e-9) {
+        double output = m_demand;
+
+        if (m_mode == kSpeed) {
+            const double error = nativeUnits (m_demand - m_speed);
+            m_integral += error;
+            output = (m_f * nativeUnits (m_demand) + m_p * error + m_i * m_integral +
+                      m_d * (error - m_lastError)) / 1023;
+            m_lastError = error;
+        }
+
+        output = fmax (m_peakReverse, fmin (m_peakForward, output));
+        m_applied = output;
+
+        if (IsCoasting())
+            m_speed -= m_speed * kStep / kCoastTimeConstant;
+        else
+            m_speed += (output * kFreeSpeed - m_speed) * kStep / kTimeConstant;
+
+        m_position += m_speed / 60 * kStep;
+        m_lastUpdate += kStep;
+    }
+}
+
+//===============================================================================
+// RobotDrive
+//===============================================================================
+
+static float limit (float value) {
+    return fmaxf (-1, fminf (1, value));
+}
+
+static float square (float value) {
+    return value >= 0 ? value * value : -(value * value);
+}
+
+RobotDrive::RobotDrive (SpeedController* leftMotor, SpeedController* rightMotor) :
+    m_frontLeftMotor (nullptr),
+    m_frontRightMotor (nullptr),
+    m_rearLeftMotor (leftMotor),
+    m_rearRightMotor (rightMotor),
+    m_maxOutput (1) {}
+
+RobotDrive::RobotDrive (SpeedController* frontLeftMotor, SpeedController* rearLeftMotor,
+                        SpeedController* frontRightMotor, SpeedController* rearRightMotor) :
+    m_frontLeftMotor (frontLeftMotor),
+    m_frontRightMotor (frontRightMotor),
+    m_rearLeftMotor (rearLeftMotor),
+    m_rearRightMotor (rearRightMotor),
+    m_maxOutput (1) {}
+
+///
+/// Same mixing as RobotDrive::ArcadeDrive in WPILib 2016
+///
+void RobotDrive::ArcadeDrive (float moveValue, float rotateValue, bool squaredInputs) {
+    moveValue = limit (moveValue);
+    rotateValue = limit (rotateValue);
+
+    if (squaredInputs) {
+        moveValue = square (moveValue);
+        rotateValue = square (rotateValue);
+    }
+
+    float left;
+    float right;
+
+    if (moveValue > 0) {
+        if (rotateValue > 0) {
+            left = moveValue - rotateValue;
+            right = fmaxf (moveValue, rotateValue);
+        } else {
+            left = fmaxf (moveValue, -rotateValue);
+            right = moveValue + rotateValue;
+        }
+    } else {
+        if (rotateValue > 0) {
+            left = -fmaxf (-moveValue, rotateValue);
+            right = moveValue + rotateValue;
+        } else {
+            left = moveValue - rotateValue;
+            right = -fmaxf (-moveValue, -rotateValue);
+        }
+    }
+
+    SetLeftRightMotorOutputs (left, right);
+}
+
+void RobotDrive::TankDrive (float leftValue, float rightValue, bool squaredInputs) {
+    leftValue = limit (leftValue);
+    rightValue = limit (rightValue);
+
+    if (squaredInputs) {
+        leftValue = square (leftValue);
+        rightValue = square (rightValue);
+    }
+
+    SetLeftRightMotorOutputs (leftValue, rightValue);
+}
+
+void RobotDrive::SetLeftRightMotorOutputs (float leftOutput, float rightOutput) {
+    const float left = limit (leftOutput) * m_maxOutput;
+    const float right = -limit (rightOutput) * m_maxOutput;
+
+    if (m_frontLeftMotor)
+        m_frontLeftMotor->Set (left);
+
+    if (m_frontRightMotor)
+        m_frontRightMotor->Set (right);
+
+    m_rearLeftMotor->Set (left);
+    m_rearRightMotor->Set (right);
+}
+
+void RobotDrive::SetMaxOutput (double maxOutput) {
+    m_maxOutput = maxOutput;
+}
+
+void RobotDrive::SetSafetyEnabled (bool enabled) {
+    (void) enabled;
+}
+
+void RobotDrive::SetExpiration (double timeout) {
+    (void) timeout;
+}
+
+void RobotDrive::StopMotor() {
+    SetLeftRightMotorOutputs (0, 0);
+}
+
+//===============================================================================
+// PowerDistributionPanel
+//===============================================================================
+
+PowerDistributionPanel::PowerDistributionPanel() {}
+
+PowerDistributionPanel::PowerDistributionPanel (uint8_t module) {
+    (void) module;
+}
+
+double PowerDistributionPanel::GetVoltage() const {
+    return Sim::busVoltage();
+}
+
+//===============================================================================
+// Compressor
+//===============================================================================
+
+Compressor::Compressor (uint8_t pcmID) :
+    m_name ("Compressor" + std::to_string (pcmID)),
+    m_output (0),
+    m_closedLoop (true) {
+    Sim::addOutput (m_name, &m_output);
+    Sim::addCompressor (this);
+}
+
+Compressor::~Compressor() {
+    Sim::removeCompressor (this);
+    Sim::removeOutput (&m_output);
+}
+
+///
+/// Like on the PCM, Start() and Stop() turn the closed-loop control on and
+/// off, and the compressor runs while it is on and the pressure is low
+///
+void Compressor::Start() {
+    SetClosedLoopControl (true);
+}
+
+void Compressor::Stop() {
+    SetClosedLoopControl (false);
+}
+
+bool Compressor::Enabled() const {
+    return m_closedLoop && GetPressureSwitchValue();
+}
+
+void Compressor::SetClosedLoopControl (bool on) {
+    Sim::addPneumaticsCommand();
+    m_closedLoop = on;
+}
+
+bool Compressor::GetClosedLoopControl() const {
+    return m_closedLoop;
+}
+
+///
+/// Returns true while the pressure is low (the switch is closed)
+///
+bool Compressor::GetPressureSwitchValue() const {
+    return Sim::pressureLow();
+}
+
+float Compressor::GetCompressorCurrent() const {
+    return Enabled() ? Sim::kCompressorCurrent : 0;
+}
+
+void Compressor::Update() {
+    m_output = Enabled();
+}
+
+//===============================================================================
+// DoubleSolenoid
+//===============================================================================
+
+DoubleSolenoid::DoubleSolenoid (uint32_t forwardChannel, uint32_t reverseChannel) :
+    DoubleSolenoid (0, forwardChannel, reverseChannel) {}
+
+DoubleSolenoid::DoubleSolenoid (uint8_t moduleNumber,
+                                uint32_t forwardChannel,
+                                uint32_t reverseChannel) :
+    m_output (kOff),
+    m_piston (kOff) {
+    Sim::addOutput ("Solenoid" + std::to_string (moduleNumber) + "_" +
+                    std::to_string (forwardChannel) + "_" +
+                    std::to_string (reverseChannel), &m_output);
+}
+
+DoubleSolenoid::~DoubleSolenoid() {
+    Sim::removeOutput (&m_output);
+}
+
+///
+/// Every time a piston moves, it uses some of the air of the tanks
+///
+void DoubleSolenoid::Set (Value value) {
+    Sim::addPneumaticsCommand();
+    if (value != kOff && value != m_piston) {
+        Sim::movePiston();
+        m_piston = value;
+    }
+
+    m_output = value;
+}
+
+DoubleSolenoid::Value DoubleSolenoid::Get() const {
+    return (Value) (int) m_output;
+}
+
+//===============================================================================
+// Ultrasonic
+//===============================================================================
+
+///
+/// Speed of sound, in inches per second
+///
+static const double kSpeedOfSound = 13500;
+
+///
+/// The range is read from the 'Ultrasonic<ping channel>' sensor of the
+/// simulation script. Like the real sensor, there is no range after a ping
+/// until its echo comes back.
+///
+Ultrasonic::Ultrasonic (uint32_t pingChannel, uint32_t echoChannel, DistanceUnit units) :
+    m_name ("Ultrasonic" + std::to_string (pingChannel)),
+    m_pingTime (-1) {
+    (void) echoChannel;
+    (void) units;
+}
+
+double Ultrasonic::GetRangeInches() const {
+    const double range = Sim::sensor (m_name, 0);
+    if (Sim::now() < m_pingTime + 2 * range / kSpeedOfSound)
+        return 0;
+
+    return range;
+}
+
+double Ultrasonic::GetRangeMM() const {
+    return GetRangeInches() * 25.4;
+}
+
+bool Ultrasonic::IsRangeValid() const {
+    return GetRangeInches() > 0;
+}
+
+void Ultrasonic::SetAutomaticMode (bool enabling) {
+    (void) enabling;
+}
+
+void Ultrasonic::Ping() {
+    m_pingTime = Sim::now();
+}
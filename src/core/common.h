@@ -29,6 +29,8 @@
 #include <memory.h>
 #include <WPILib.h>
 
+#include "core/input_shaping.h"
+
 using namespace std;
 
 ///
@@ -42,8 +44,10 @@ using namespace std;
 ///
 /// Change these when needed
 ///
-const bool USES_OFFICIAL_DS = true;
-const bool IS_CLONE         = false;
+const bool USES_OFFICIAL_DS   = true;
+const bool IS_CLONE           = false;
+const bool ENABLE_LOOP_TIMING = false;
+const bool ENABLE_TELEMETRY   = true;
 
 ///
 /// Motor/actuator identifiers
@@ -74,122 +78,282 @@ const int kShooterRadarEcho    = 2;
 }
 
 ///
-/// Components of the pneumatic system
+/// Ultrasonic rangefinder of the shooter (see Rangefinder), times are in
+/// seconds
+///
+namespace Ranging {
+const double kPeriod           = 0.05;
+const double kMaxAge           = 0.25;
+const int kWindow              = 5;
+const float kSmoothing         = 0.5;
+}
+
+///
+/// Components of the pneumatic system. The compressor is stopped while the
+/// motors of the drivetrain and the shooter draw more than kShedCurrent
+/// amps, and started again once they have drawn less than kResumeCurrent
+/// for kResumeDelay seconds (see Lifter).
 ///
 namespace Pneumatics {
 const int kCompressor          = 0;
 const int kLifterPiston_Up     = 0;
 const int kLifterPiston_Down   = 1;
+const double kShedCurrent      = 120;
+const double kResumeCurrent    = 60;
+const double kResumeDelay      = 0.5;
 }
 
 ///
-/// Controller mappings for Xbox 360
+/// Closed-loop speed control of the shooter wheels (see Shooter). The gains
+/// are in the units of the Talon: 1023 is the full output, and speeds are in
+/// encoder edges per 100 ms
 ///
-namespace X360_Mappings {
-const int kAxisLeftX           = 0;
-const int kAxisLeftY           = 1;
-const int kAxisRightX          = USES_OFFICIAL_DS ? 4 : 3;
-const int kAxisRightY          = USES_OFFICIAL_DS ? 5 : 4;
-const int kAxisLeftTrigger     = 2;
-const int kAxisRightTrigger    = USES_OFFICIAL_DS ? 3 : 2;
-const int kButtonA             = 1;
-const int kButtonB             = 2;
-const int kButtonX             = 3;
-const int kButtonY             = 4;
-const int kButtonBack          = 7;
-const int kButtonStart         = 8;
-const int kButtonLeftBumper    = 5;
-const int kButtonRightBumper   = 6;
+namespace Flywheel {
+const int kEncoderCodes        = 256;
+const double kFreeRPM          = 5300;
+const double kMaxRPM           = 4500;
+const double kToleranceRPM     = 100;
+const double kP                = 0.6;
+const double kI                = 0;
+const double kD                = 0;
+const double kF                = 1023 / (kFreeRPM * kEncoderCodes * 4 / 600);
 }
 
 ///
-/// Controller mappings for Xbox One controllers
+/// Drivetrain geometry, used to turn the positions of the drive encoders
+/// into distances and a heading. Lengths are in inches, the track width is
+/// the effective one (measured by turning in place, the wheels scrub) and
+/// the encoders are on the motor shafts. The free speed of the wheels is in
+/// inches per second.
 ///
-namespace XBOX_ONE_Mappings {
-const int kAxisLeftX           = 0;
-const int kAxisLeftY           = 1;
-const int kAxisRightX          = USES_OFFICIAL_DS ? 4 : 3;
-const int kAxisRightY          = USES_OFFICIAL_DS ? 5 : 4;
-const int kAxisLeftTrigger     = 2;
-const int kAxisRightTrigger    = USES_OFFICIAL_DS ? 3 : 5;
-const int kButtonA             = 1;
-const int kButtonB             = 2;
-const int kButtonX             = 3;
-const int kButtonY             = 4;
-const int kButtonBack          = 7;
-const int kButtonStart         = 8;
-const int kButtonLeftBumper    = 5;
-const int kButtonRightBumper   = 6;
+namespace Drive {
+const int kEncoderCodes        = 20;
+const double kGearRatio        = 10.71;
+const double kWheelDiameter    = 11;
+const double kTrackWidth       = 40;
+const double kFreeSpeed        = 5300 / kGearRatio / 60 * M_PI * kWheelDiameter;
 }
 
 ///
-/// Defines the joysticks, buttons and axes used by each system
+/// Motion profiles of the autonomous routines (see Autonomous). Distances
+/// are in inches and times in seconds. The feed-forward gains give the
+/// output needed per inch/s of velocity (V) and per inch/s^2 of
+/// acceleration (A), the feedback gains act on the position error (P) and
+/// on its rate of change (D). Once a profile has ended, the motors are left
+/// off while both sides are within kTolerance of the final position.
 ///
-namespace OI {
-/* Shooter interface */
-const int kBruteShootButton    = X360_Mappings::kButtonB;
-const int kSmartShootButton    = X360_Mappings::kButtonY;
-const int kEnableActuator      = X360_Mappings::kAxisLeftY;
-const int kShootLeftAxis       = X360_Mappings::kAxisLeftTrigger;
-const int kShootRightAxis      = X360_Mappings::kAxisRightTrigger;
+namespace Profiles {
+const double kPeriod           = 0.01;
+const double kMaxVelocity      = 120;
+const double kMaxAcceleration  = 80;
+const double kV                = 1 / Drive::kFreeSpeed;
+const double kA                = 0.001;
+const double kP                = 0.05;
+const double kD                = 0;
+const double kTolerance        = 0.5;
+const double kCrossDistance    = 180;
+}
 
-/* Intake & hands interface */
-const int kLiftHand            = X360_Mappings::kButtonBack;
-const int kDropHand            = X360_Mappings::kButtonStart;
-const int kIntakeTake          = X360_Mappings::kAxisLeftTrigger;
-const int kIntakeGive          = X360_Mappings::kAxisRightTrigger;
+///
+/// Power budget (see PowerBudget). The motors share the current that keeps
+/// the battery above kMinVoltage, estimated with the resistance of the
+/// battery and its wiring (in ohms). The scales of the outputs go back up by
+/// kRecoveryRate per cycle, and the current a consumer asks for is estimated
+/// with a scale of at least kMinScale. The flywheels are limited through the
+/// peak output voltage of their Talons, in steps of kPeakVoltageStep volts.
+///
+namespace Power {
+const double kMinVoltage       = 8;
+const double kResistance       = 0.015;
+const float kRecoveryRate      = 0.02;
+const float kMinScale          = 0.2;
+const double kMaxVoltage       = 12;
+const double kPeakVoltageStep  = 0.5;
+}
 
-/* Piston lifter interface */
-const int kEnableCompressor    = X360_Mappings::kButtonX;
-const int kLifterUp            = X360_Mappings::kButtonLeftBumper;
-const int kLifterDown          = X360_Mappings::kButtonRightBumper;
+///
+/// Autonomous routine loaded when the robot program starts (see Sequencer),
+/// the path can be changed with KZ_ROUTINE
+///
+namespace Routines {
+const char* const kPath        = "/home/lvuser/autonomous.kzr";
+const int kMaxProfiles         = 8;
+}
 
-/* Powertrain */
-const int kY_DriveAxis         = X360_Mappings::kAxisLeftY;
-const int kX_DriveAxis         = X360_Mappings::kAxisLeftX;
-const int kY_SlowDriveAxis     = X360_Mappings::kAxisRightY;
-const int kX_SlowDriveAxis     = X360_Mappings::kAxisRightX;
-const int kY_InvertButton      = X360_Mappings::kButtonA;
-const int kBlockStickB         = X360_Mappings::kButtonX;
-const int kSensivityAxis       = X360_Mappings::kAxisRightY;
+///
+/// Alignment with the vision target (see AutoAim). Angles are in degrees,
+/// the gains give a rotation output per degree of error (P) and per degree
+/// per second of turn rate (D). Frames older than kMaxLatency seconds are
+/// not used.
+///
+namespace Aim {
+const double kP                = 0.06;
+const double kD                = 0.012;
+const double kMinOutput        = 0.3;
+const double kMaxOutput        = 0.6;
+const double kTolerance        = 1;
+const double kMaxLatency       = 0.25;
+}
+
+///
+/// Control loop (see ControlLoop), which runs the subsystems every kPeriod
+/// seconds with the latest driver station packet. Packets older than
+/// kMaxPacketAge seconds are not used. The notifier thread runs with the
+/// real-time priority kPriority (SCHED_FIFO).
+///
+namespace Control {
+const double kPeriod           = 0.005;
+const double kMaxPacketAge     = 0.1;
+const int kPriority            = 40;
 }
 
 ///
-/// Avoids involuntary movement and allows the program to control
-/// how sensible the robot actuators are.
+/// Control loop timing (see LoopTiming), the budget of a cycle is its period,
+/// the jitter is measured in buckets of 1/500 of it (10 us at 200 Hz)
 ///
-/// First, we check that the input meets the minimum value required
-/// to move a motor. If not, the function will return 0.
+namespace Timing {
+const int kLoopBudgetUs        = (int) (Control::kPeriod * 1e6);
+const int kJitterBucketUs      = kLoopBudgetUs / 500;
+const int kMaxPeriodUs         = 1000000;
+const int kSummaryPeriodMs     = 1000;
+}
+
+///
+/// Match recorder (see TelemetryRecorder), only the last kKeepLogs logs are
+/// kept in the directory
+///
+namespace Telemetry {
+const char* const kDirectory   = "/home/lvuser";
+const int kRingSize            = 8192;
+const int kFlushPeriodMs       = 100;
+const int kKeepLogs            = 20;
+}
+
 ///
-/// Then, we apply the following function to adjust the input value
-/// to the defined sensitivity:
+/// USB camera used by the vision pipeline, the latency is the time between
+/// the exposure of a frame and its arrival (in seconds)
 ///
-/// y = (a)(x^3) + (1 - a)(x)
+namespace Cameras {
+const char* const kVisionCamera = "cam0";
+const int kWidth               = 640;
+const int kHeight              = 480;
+const int kFPS                 = 30;
+const double kHorizontalFOV    = 60;
+const double kLatency          = 0.06;
+}
+
+///
+/// Controller mappings for Xbox 360 (the axes and buttons reported by the
+/// driver station for each control of the controller)
 ///
-/// Where:
-///     - x is the input (from -1 to 1)
-///     - a is the sensitivity (from 0 to 1)
-///     - y is the resultant (from -1 to 1)
+struct X360_Mappings {
+    static const int kAxisLeftX         = 0;
+    static const int kAxisLeftY         = 1;
+    static const int kAxisRightX        = USES_OFFICIAL_DS ? 4 : 3;
+    static const int kAxisRightY        = USES_OFFICIAL_DS ? 5 : 4;
+    static const int kAxisLeftTrigger   = 2;
+    static const int kAxisRightTrigger  = USES_OFFICIAL_DS ? 3 : 2;
+    static const int kButtonA           = 1;
+    static const int kButtonB           = 2;
+    static const int kButtonX           = 3;
+    static const int kButtonY           = 4;
+    static const int kButtonBack        = 7;
+    static const int kButtonStart       = 8;
+    static const int kButtonLeftBumper  = 5;
+    static const int kButtonRightBumper = 6;
+};
+
+///
+/// Controller mappings for Xbox One controllers
 ///
-/// We raise x to the third power (x^3) in order to:
-///     - Obtain a 'curved' output
-///     - Obtain both positive and negative values
+struct XBOX_ONE_Mappings {
+    static const int kAxisLeftX         = 0;
+    static const int kAxisLeftY         = 1;
+    static const int kAxisRightX        = USES_OFFICIAL_DS ? 4 : 3;
+    static const int kAxisRightY        = USES_OFFICIAL_DS ? 5 : 4;
+    static const int kAxisLeftTrigger   = 2;
+    static const int kAxisRightTrigger  = USES_OFFICIAL_DS ? 3 : 5;
+    static const int kButtonA           = 1;
+    static const int kButtonB           = 2;
+    static const int kButtonX           = 3;
+    static const int kButtonY           = 4;
+    static const int kButtonBack        = 7;
+    static const int kButtonStart       = 8;
+    static const int kButtonLeftBumper  = 5;
+    static const int kButtonRightBumper = 6;
+};
+
 ///
-/// When the sensitivity is set to 0, y = x^3
+/// Layout of the joysticks in the driver station packets (see DriverPacket).
+/// The axes of every controller are read into these places, using the
+/// profile of the controller (see ControllerProfile), so the bindings of OI
+/// do not depend on the controller. The buttons are the same on every
+/// controller.
 ///
-inline float ADJUST_INPUT (float input, float sensitivity) {
-    if (abs (input) < abs (MIN_OUTPUT))
-        return 0;
+struct Controller {
+    static const int kAxisLeftX         = 0;
+    static const int kAxisLeftY         = 1;
+    static const int kAxisLeftTrigger   = 2;
+    static const int kAxisRightTrigger  = 3;
+    static const int kAxisRightX        = 4;
+    static const int kAxisRightY        = 5;
+    static const int kButtonA           = X360_Mappings::kButtonA;
+    static const int kButtonB           = X360_Mappings::kButtonB;
+    static const int kButtonX           = X360_Mappings::kButtonX;
+    static const int kButtonY           = X360_Mappings::kButtonY;
+    static const int kButtonBack        = X360_Mappings::kButtonBack;
+    static const int kButtonStart       = X360_Mappings::kButtonStart;
+    static const int kButtonLeftBumper  = X360_Mappings::kButtonLeftBumper;
+    static const int kButtonRightBumper = X360_Mappings::kButtonRightBumper;
+};
 
-    float s = abs (sensitivity);
-    float final = (s * pow (input, 3)) + (1 - s) * input;
-    return final;
+///
+/// Curve applied to every axis of the joysticks (see InputSnapshot). The
+/// subsystems scale the shaped axes, so the deadband is always measured on
+/// the position of the stick.
+///
+namespace Inputs {
+const float kDeadband          = MIN_OUTPUT;
+const float kSensitivity       = 0;
 }
 
 ///
-/// Overloaded function with a sensitivity of 0.2
+/// Defines the joysticks, buttons and axes used by each system
 ///
-inline float ADJUST_INPUT (float input) {
-    return ADJUST_INPUT (input, 0.2);
+namespace OI {
+/* Driver station ports */
+const int kDriveJoystick       = 0;
+const int kSecondJoystick      = 1;
+
+/* Shooter interface */
+const int kBruteShootButton    = Controller::kButtonB;
+const int kReverseShootButton  = Controller::kButtonA;
+const int kSmartShootButton    = Controller::kButtonY;
+const int kEnableActuator      = Controller::kAxisLeftY;
+const int kShootLeftAxis       = Controller::kAxisLeftTrigger;
+const int kShootRightAxis      = Controller::kAxisRightTrigger;
+
+/* Intake & hands interface */
+const int kLiftHand            = Controller::kButtonBack;
+const int kDropHand            = Controller::kButtonStart;
+const int kIntakeTake          = Controller::kAxisLeftTrigger;
+const int kIntakeGive          = Controller::kAxisRightTrigger;
+
+/* Piston lifter interface, each press of kToggleCompressorAuto turns the
+   automatic control of the compressor off or back on (it starts on) */
+const int kToggleCompressorAuto = Controller::kButtonX;
+const int kLifterUp            = Controller::kButtonLeftBumper;
+const int kLifterDown          = Controller::kButtonRightBumper;
+
+/* Powertrain */
+const int kAutoAimButton       = Controller::kButtonRightBumper;
+const int kSensitivityButton   = Controller::kButtonLeftBumper;
+const int kY_DriveAxis         = Controller::kAxisLeftY;
+const int kX_DriveAxis         = Controller::kAxisLeftX;
+const int kY_SlowDriveAxis     = Controller::kAxisRightY;
+const int kX_SlowDriveAxis     = Controller::kAxisRightX;
+const int kY_InvertButton      = Controller::kButtonA;
+const int kBlockStickB         = Controller::kButtonX;
+const int kSensivityAxis       = Controller::kAxisRightY;
 }
 
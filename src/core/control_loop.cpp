@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "control_loop.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+///
+/// Dashboard keys of the profile of each joystick
+///
+static const char* kDashboardKeys[DriverPacket::kJoysticks] = {
+    "Drive Controller", "Second Controller"
+};
+
+//===============================================================================
+// ControlLoop::ControlLoop
+//===============================================================================
+
+ControlLoop::ControlLoop (Handler handler) :
+    m_handler (handler),
+    m_notifier (&ControlLoop::run, this),
+    m_unchosen (DriverPacket::kJoysticks),
+    m_published (0),
+    m_handled (0),
+    m_prioritySet (false) {
+    for (int i = 0; i < DriverPacket::kJoysticks; ++i) {
+        m_profiles[i] = &ControllerProfile::find ("");
+        m_chosen[i] = false;
+    }
+}
+
+//===============================================================================
+// ControlLoop::~ControlLoop
+//===============================================================================
+
+ControlLoop::~ControlLoop() {
+    stop();
+}
+
+//===============================================================================
+// ControlLoop::start
+//===============================================================================
+
+void ControlLoop::start() {
+    m_notifier.StartPeriodic (Control::kPeriod);
+}
+
+//===============================================================================
+// ControlLoop::stop
+//===============================================================================
+
+void ControlLoop::stop() {
+    m_notifier.Stop();
+}
+
+//===============================================================================
+// ControlLoop::publish
+//===============================================================================
+
+///
+/// (Packet loop) Reads the driver station and hands the packet to the next
+/// control cycle, the controller profiles are chosen first if they were not
+///
+void ControlLoop::publish (DriverPacket::Mode mode) {
+    if (m_unchosen > 0)
+        selectControllers();
+
+    DriverPacket packet;
+    packet.read (mode, m_profiles);
+    packet.sequence = ++m_published;
+    m_packets.store (packet);
+}
+
+//===============================================================================
+// ControlLoop::run
+//===============================================================================
+
+///
+/// (Notifier) Runs a control cycle with the latest packet
+///
+void ControlLoop::run() {
+    if (!m_prioritySet)
+        raisePriority();
+
+    DriverPacket packet;
+    if (!m_packets.load (packet))
+        return;
+
+    if (Timer::GetFPGATimestamp() - packet.timestamp > Control::kMaxPacketAge)
+        return;
+
+    const bool fresh = packet.sequence != m_handled;
+    m_handled = packet.sequence;
+    m_handler (packet, fresh);
+}
+
+//===============================================================================
+// ControlLoop::raisePriority
+//===============================================================================
+
+///
+/// Makes the current (notifier) thread a real-time thread, this is only
+/// tried once
+///
+void ControlLoop::raisePriority() {
+    m_prioritySet = true;
+
+    sched_param param;
+    param.sched_priority = Control::kPriority;
+
+    const int error = pthread_setschedparam (pthread_self(), SCHED_FIFO, &param);
+    if (error != 0)
+        printf ("Control: cannot use a real-time priority (%s)\n", strerror (error));
+}
+
+//===============================================================================
+// ControlLoop::selectControllers
+//===============================================================================
+
+///
+/// (Packet loop) Finds the profile of the controller plugged in each port
+/// that has none yet, once the driver station is attached and names it. A
+/// controller that is changed afterwards is only seen when the program
+/// restarts.
+///
+void ControlLoop::selectControllers() {
+    DriverStation& ds = DriverStation::GetInstance();
+    if (!ds.IsDSAttached())
+        return;
+
+    for (int i = 0; i < DriverPacket::kJoysticks; ++i) {
+        if (m_chosen[i])
+            continue;
+
+        const std::string name = ds.GetJoystickName (DriverPacket::kPorts[i]);
+        if (name.empty())
+            continue;
+
+        m_profiles[i] = &ControllerProfile::find (name.c_str());
+        m_chosen[i] = true;
+        --m_unchosen;
+
+        printf ("Control: joystick %u uses the %s profile\n", DriverPacket::kPorts[i],
+                m_profiles[i]->name);
+        SD::PutString (kDashboardKeys[i], m_profiles[i]->name);
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+
+#include "core/common.h"
+#include "core/inputs.h"
+#include "core/latest_value.h"
+
+///
+/// Runs the control of the robot at a fixed rate, decoupled from the driver
+/// station packets.
+///
+/// The packet loop (the Periodic functions of IterativeRobot) only reads
+/// the driver station and publishes the packet with publish(). A notifier
+/// calls the handler every Control::kPeriod seconds with the latest packet,
+/// which is passed over through a lock-free slot (see LatestValue): neither
+/// side ever waits for the other. The handler is told when the packet is a
+/// new one, and is not called at all when the latest packet is older than
+/// Control::kMaxPacketAge (the driver station stopped sending them).
+///
+/// The profile of each joystick (see ControllerProfile) is chosen once, from
+/// the name of its controller, by the first packet for which the driver
+/// station is attached and reports that name (it is not connected yet when
+/// the robot boots). Until then, the joystick is read with the default
+/// profile.
+///
+/// The notifier thread is given a real-time priority when it first runs the
+/// handler, so the control cycles are not delayed by the other threads of
+/// the program (the WPILib notifiers all share that thread).
+///
+class ControlLoop {
+  public:
+    typedef std::function<void (const DriverPacket& packet, bool fresh)> Handler;
+
+    explicit ControlLoop (Handler handler);
+    ~ControlLoop();
+
+    void start();
+    void stop();
+    void publish (DriverPacket::Mode mode);
+
+  private:
+    void run();
+    void raisePriority();
+    void selectControllers();
+
+    Handler m_handler;
+    Notifier m_notifier;
+    LatestValue<DriverPacket> m_packets;
+    const ControllerProfile* m_profiles[DriverPacket::kJoysticks];
+    bool m_chosen[DriverPacket::kJoysticks];
+    int m_unchosen;
+
+    uint32_t m_published;
+    uint32_t m_handled;
+    bool m_prioritySet;
+};
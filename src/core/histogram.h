@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <algorithm>
+
+///
+/// Distribution of durations (in microseconds), stored in fixed-width
+/// buckets. Samples are added by one thread without any locking and can be
+/// read at any time by other threads.
+///
+class Histogram {
+  public:
+    static const int kBuckets = 64;
+    static const uint32_t kDefaultWidth = 25;
+
+    explicit Histogram (uint32_t bucketWidth = kDefaultWidth) : m_width (bucketWidth) {
+        reset();
+    }
+
+    void reset() {
+        for (int i = 0; i < kBuckets; ++i)
+            m_buckets[i].store (0, std::memory_order_relaxed);
+
+        m_count.store (0, std::memory_order_relaxed);
+        m_total.store (0, std::memory_order_relaxed);
+        m_max.store (0, std::memory_order_relaxed);
+    }
+
+    ///
+    /// Adds a sample, the last bucket holds every sample that is too large
+    /// for the other ones
+    ///
+    void add (uint32_t micros) {
+        uint32_t bucket = micros / m_width;
+        if (bucket >= kBuckets)
+            bucket = kBuckets - 1;
+
+        m_buckets[bucket].fetch_add (1, std::memory_order_relaxed);
+        m_count.fetch_add (1, std::memory_order_relaxed);
+        m_total.fetch_add (micros, std::memory_order_relaxed);
+
+        if (micros > m_max.load (std::memory_order_relaxed))
+            m_max.store (micros, std::memory_order_relaxed);
+    }
+
+    uint32_t count() const {
+        return m_count.load (std::memory_order_relaxed);
+    }
+
+    uint32_t max() const {
+        return m_max.load (std::memory_order_relaxed);
+    }
+
+    double mean() const {
+        uint32_t samples = count();
+        return samples ? (double) m_total.load (std::memory_order_relaxed) / samples : 0;
+    }
+
+    ///
+    /// Returns the upper bound of the bucket that holds the given percentile
+    /// (from 0 to 100) of the samples, or the largest sample if it is lower
+    ///
+    uint32_t percentile (double p) const {
+        const uint64_t target = (uint64_t) (p / 100 * count() + 0.5);
+        const uint32_t largest = max();
+        uint64_t seen = 0;
+
+        for (int i = 0; i < kBuckets - 1; ++i) {
+            seen += m_buckets[i].load (std::memory_order_relaxed);
+            if (seen >= target && seen > 0)
+                return std::min ((uint32_t) (i + 1) * m_width, largest);
+        }
+
+        return largest;
+    }
+
+  private:
+    const uint32_t m_width;
+
+    std::atomic<uint32_t> m_buckets[kBuckets];
+    std::atomic<uint32_t> m_count;
+    std::atomic<uint64_t> m_total;
+    std::atomic<uint32_t> m_max;
+};
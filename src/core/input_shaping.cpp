@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "input_shaping.h"
+
+//===============================================================================
+// InputCurve::shape
+//===============================================================================
+
+///
+/// Shapes count inputs, the outputs can be the inputs
+///
+void InputCurve::shape (const float* inputs, float* outputs, int count) const {
+    switch (type) {
+        case kCubic:
+            for (int i = 0; i < count; ++i)
+                outputs[i] = deadbandValue (inputs[i], cubicValue (inputs[i]));
+            break;
+        case kExpo:
+            for (int i = 0; i < count; ++i)
+                outputs[i] = deadbandValue (inputs[i], expoValue (inputs[i]));
+            break;
+        case kTable:
+            for (int i = 0; i < count; ++i)
+                outputs[i] = deadbandValue (inputs[i], tableValue (inputs[i]));
+            break;
+    }
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <math.h>
+
+///
+/// Curve applied to the inputs of the drivers. Inputs closer to zero than
+/// the deadband are zeroed (to avoid involuntary movement), the others go
+/// through the curve, which sets how sensible the actuators are:
+///
+///     kCubic   y = s x^3 + (1 - s) x, where s is the sensitivity (from 0 to
+///              1, a sensitivity of 0 keeps the input as it is)
+///     kExpo    y = x e^(s (|x| - 1)), where s is the sensitivity (0 keeps
+///              the input as it is, the curve is flatter around zero when it
+///              is higher)
+///     kTable   linear between the points of the table, which are evenly
+///              spaced from -1 to 1
+///
+/// shape() with an array shapes every value in a single pass: the type of
+/// the curve is looked at once, and the loop has no branches (the deadband
+/// is a select), so that the compiler can vectorize it. The inputs go from
+/// -1 to 1.
+///
+/// This file does not depend on WPILib, so the tools can use it.
+///
+struct InputCurve {
+    enum Type {
+        kCubic,
+        kExpo,
+        kTable,
+    };
+
+    static const int kTablePoints = 9;
+
+    Type type;
+    float deadband;
+    float sensitivity;
+    float table[kTablePoints];
+
+    static InputCurve cubic (float sensitivity, float deadband);
+    static InputCurve expo (float sensitivity, float deadband);
+    static InputCurve linear (const float (&points)[kTablePoints], float deadband);
+
+    float shape (float input) const;
+    void shape (const float* inputs, float* outputs, int count) const;
+
+    float cubicValue (float input) const;
+    float expoValue (float input) const;
+    float tableValue (float input) const;
+    float deadbandValue (float input, float value) const;
+};
+
+//===============================================================================
+// InputCurve::cubic
+//===============================================================================
+
+inline InputCurve InputCurve::cubic (float sensitivity, float deadband) {
+    InputCurve curve = { kCubic, deadband, fabsf (sensitivity), {} };
+    return curve;
+}
+
+//===============================================================================
+// InputCurve::expo
+//===============================================================================
+
+inline InputCurve InputCurve::expo (float sensitivity, float deadband) {
+    InputCurve curve = { kExpo, deadband, sensitivity, {} };
+    return curve;
+}
+
+//===============================================================================
+// InputCurve::linear
+//===============================================================================
+
+inline InputCurve InputCurve::linear (const float (&points)[kTablePoints], float deadband) {
+    InputCurve curve = { kTable, deadband, 0, {} };
+    for (int i = 0; i < kTablePoints; ++i)
+        curve.table[i] = points[i];
+
+    return curve;
+}
+
+//===============================================================================
+// InputCurve::shape
+//===============================================================================
+
+///
+/// Shapes a single input
+///
+inline float InputCurve::shape (float input) const {
+    switch (type) {
+        case kCubic:
+            return deadbandValue (input, cubicValue (input));
+        case kExpo:
+            return deadbandValue (input, expoValue (input));
+        case kTable:
+            return deadbandValue (input, tableValue (input));
+    }
+
+    return 0;
+}
+
+//===============================================================================
+// InputCurve::cubicValue
+//===============================================================================
+
+///
+/// The cube is computed in double precision, like pow() did when the curve
+/// was applied to each input by itself, so the results are the same
+///
+inline float InputCurve::cubicValue (float input) const {
+    const double cube = (double) input * input * input;
+    return (float) (sensitivity * cube + (1 - sensitivity) * input);
+}
+
+//===============================================================================
+// InputCurve::expoValue
+//===============================================================================
+
+inline float InputCurve::expoValue (float input) const {
+    return input * expf (sensitivity * (fabsf (input) - 1));
+}
+
+//===============================================================================
+// InputCurve::tableValue
+//===============================================================================
+
+inline float InputCurve::tableValue (float input) const {
+    const float last = kTablePoints - 1;
+    const float position = fminf (fmaxf ((input + 1) * last / 2, 0), last);
+    const int index = (int) fminf (position, last - 1);
+    const float t = position - index;
+    return table[index] + t * (table[index + 1] - table[index]);
+}
+
+//===============================================================================
+// InputCurve::deadbandValue
+//===============================================================================
+
+inline float InputCurve::deadbandValue (float input, float value) const {
+    return fabsf (input) < deadband ? 0 : value;
+}
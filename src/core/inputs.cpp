@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <ctype.h>
+#include <string.h>
+
+#include "inputs.h"
+
+///
+/// Profiles of the controllers used by the drivers, the first one is used
+/// when the controller is not known
+///
+static constexpr ControllerProfile kProfiles[] = {
+    ControllerProfile::of<X360_Mappings>     ("Xbox 360", "xbox 360"),
+    ControllerProfile::of<XBOX_ONE_Mappings> ("Xbox One", "xbox one"),
+};
+
+///
+/// Curve applied to the axes of the snapshot
+///
+static const InputCurve kCurve = InputCurve::cubic (Inputs::kSensitivity, Inputs::kDeadband);
+
+const uint32_t DriverPacket::kPorts[] = { OI::kDriveJoystick, OI::kSecondJoystick };
+
+//===============================================================================
+// JoystickState::JoystickState
+//===============================================================================
+
+JoystickState::JoystickState() : m_buttons (0), m_pressed (0), m_released (0) {
+    for (int i = 0; i < kAxes; ++i) {
+        m_axes[i] = 0;
+        m_shaped[i] = 0;
+    }
+}
+
+//===============================================================================
+// JoystickState::update
+//===============================================================================
+
+///
+/// Replaces the state of the joystick, and finds the buttons that changed
+///
+void JoystickState::update (const float* axes, const float* shaped, uint32_t buttons) {
+    for (int i = 0; i < kAxes; ++i) {
+        m_axes[i] = axes[i];
+        m_shaped[i] = shaped[i];
+    }
+
+    m_pressed  = buttons & ~m_buttons;
+    m_released = m_buttons & ~buttons;
+    m_buttons  = buttons;
+}
+
+//===============================================================================
+// ControllerProfile::find
+//===============================================================================
+
+///
+/// Returns the profile whose model is in the name of a controller (as
+/// reported by the driver station), or the default profile
+///
+const ControllerProfile& ControllerProfile::find (const char* controller) {
+    char name[64] = {0};
+    for (size_t i = 0; controller[i] && i < sizeof (name) - 1; ++i)
+        name[i] = tolower ((unsigned char) controller[i]);
+
+    for (const ControllerProfile& profile : kProfiles) {
+        if (strstr (name, profile.model))
+            return profile;
+    }
+
+    return kProfiles[0];
+}
+
+//===============================================================================
+// DriverPacket::read
+//===============================================================================
+
+///
+/// Reads the axes and the buttons of the drive and second joysticks, the
+/// axes are read in the order of the Controller layout with the profile of
+/// each joystick
+///
+void DriverPacket::read (Mode mode,
+                         const ControllerProfile* const (&profiles)[kJoysticks]) {
+    DriverStation& ds = DriverStation::GetInstance();
+    for (int i = 0; i < kJoysticks; ++i) {
+        buttons[i] = ds.GetStickButtons (kPorts[i]);
+        this->profiles[i] = profiles[i];
+        for (int j = 0; j < JoystickState::kAxes; ++j)
+            axes[i][j] = ds.GetStickAxis (kPorts[i], profiles[i]->axes[j]);
+    }
+
+    this->mode = mode;
+    timestamp = Timer::GetFPGATimestamp();
+}
+
+//===============================================================================
+// InputSnapshot::update
+//===============================================================================
+
+///
+/// Shapes the axes of both joysticks (they are contiguous in the packet) and
+/// updates the joysticks
+///
+void InputSnapshot::update (const DriverPacket& packet) {
+    float shaped[DriverPacket::kJoysticks][JoystickState::kAxes];
+    kCurve.shape (packet.axes[0], shaped[0], DriverPacket::kJoysticks * JoystickState::kAxes);
+
+    drive.update  (packet.axes[0], shaped[0], packet.buttons[0]);
+    second.update (packet.axes[1], shaped[1], packet.buttons[1]);
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "core/common.h"
+
+///
+/// State of a joystick during one loop: the axes (as read and shaped by the
+/// curve of Inputs), a bitmask with the buttons that are held down, and the
+/// buttons that were pressed or released since the previous loop.
+///
+/// Buttons are numbered from 1, like in the WPILib Joystick class.
+///
+class JoystickState {
+  public:
+    static const int kAxes = 6;
+
+    explicit JoystickState();
+
+    void update (const float* axes, const float* shaped, uint32_t buttons);
+
+    float axis (int axis) const;
+    float shaped (int axis) const;
+    bool button (int button) const;
+    bool pressed (int button) const;
+    bool released (int button) const;
+    uint32_t buttons() const;
+
+  private:
+    static uint32_t bit (int button);
+
+    float m_axes[kAxes];
+    float m_shaped[kAxes];
+    uint32_t m_buttons;
+    uint32_t m_pressed;
+    uint32_t m_released;
+};
+
+///
+/// Axes of a controller model, as reported by the driver station: entry i is
+/// the axis read into place i of the packet (see Controller in common.h).
+///
+/// The profiles are generated at compile time from the mapping tables of
+/// common.h (see of()). The control loop finds the profile of each joystick
+/// from the name of its controller when the program starts, so reading a
+/// packet is a fixed lookup per axis, whatever the controller.
+///
+struct ControllerProfile {
+    const char* name;
+    const char* model;
+    uint8_t axes[JoystickState::kAxes];
+
+    template <class Mappings>
+    static constexpr ControllerProfile of (const char* name, const char* model);
+
+    static const ControllerProfile& find (const char* controller);
+};
+
+///
+/// Raw values of a driver station packet, read by the packet loop and handed
+/// to the control loop (see ControlLoop). The axes are in the order of the
+/// Controller layout, read with the given profile of each joystick.
+///
+struct DriverPacket {
+    enum Mode {
+        kDisabled,
+        kAutonomous,
+        kTeleop,
+    };
+
+    static const int kJoysticks = 2;
+    static const uint32_t kPorts[kJoysticks];
+
+    double timestamp;
+    uint32_t sequence;
+    uint8_t mode;
+    uint32_t buttons[kJoysticks];
+    float axes[kJoysticks][JoystickState::kAxes];
+    const ControllerProfile* profiles[kJoysticks];
+
+    void read (Mode mode, const ControllerProfile* const (&profiles)[kJoysticks]);
+};
+
+///
+/// Inputs of the driver station, updated once at the start of each control
+/// cycle and passed to the subsystems by reference. The subsystems never
+/// read the joysticks by themselves, so a cycle only depends on its
+/// snapshot. The snapshot is updated on every cycle (even when the packet
+/// did not change), so a button is only seen as pressed by one cycle.
+///
+/// The axes of both joysticks are shaped together, in a single pass (see
+/// InputCurve).
+///
+struct InputSnapshot {
+    JoystickState drive;
+    JoystickState second;
+
+    void update (const DriverPacket& packet);
+};
+
+//===============================================================================
+// ControllerProfile::of
+//===============================================================================
+
+///
+/// Returns the profile of the controller described by a mapping table, the
+/// model is the text (in lower case) that the name of the controller contains
+///
+template <class Mappings>
+constexpr ControllerProfile ControllerProfile::of (const char* name, const char* model) {
+    static_assert (Controller::kAxisLeftX == 0 && Controller::kAxisLeftY == 1 &&
+                   Controller::kAxisLeftTrigger == 2 && Controller::kAxisRightTrigger == 3 &&
+                   Controller::kAxisRightX == 4 && Controller::kAxisRightY == 5,
+                   "The axes of a profile must be in the order of the Controller layout");
+    static_assert (JoystickState::kAxes == 6, "Every axis must have its place in a profile");
+    static_assert (Mappings::kButtonA == Controller::kButtonA &&
+                   Mappings::kButtonB == Controller::kButtonB &&
+                   Mappings::kButtonX == Controller::kButtonX &&
+                   Mappings::kButtonY == Controller::kButtonY &&
+                   Mappings::kButtonBack == Controller::kButtonBack &&
+                   Mappings::kButtonStart == Controller::kButtonStart &&
+                   Mappings::kButtonLeftBumper == Controller::kButtonLeftBumper &&
+                   Mappings::kButtonRightBumper == Controller::kButtonRightBumper,
+                   "The buttons are not remapped, they must be the same on every controller");
+
+    return {
+        name, model, {
+            Mappings::kAxisLeftX,
+            Mappings::kAxisLeftY,
+            Mappings::kAxisLeftTrigger,
+            Mappings::kAxisRightTrigger,
+            Mappings::kAxisRightX,
+            Mappings::kAxisRightY,
+        }
+    };
+}
+
+//===============================================================================
+// JoystickState::axis
+//===============================================================================
+
+inline float JoystickState::axis (int axis) const {
+    return axis >= 0 && axis < kAxes ? m_axes[axis] : 0;
+}
+
+//===============================================================================
+// JoystickState::shaped
+//===============================================================================
+
+///
+/// Returns an axis after the deadband and the curve of Inputs
+///
+inline float JoystickState::shaped (int axis) const {
+    return axis >= 0 && axis < kAxes ? m_shaped[axis] : 0;
+}
+
+//===============================================================================
+// JoystickState::button
+//===============================================================================
+
+inline bool JoystickState::button (int button) const {
+    return m_buttons & bit (button);
+}
+
+//===============================================================================
+// JoystickState::pressed
+//===============================================================================
+
+inline bool JoystickState::pressed (int button) const {
+    return m_pressed & bit (button);
+}
+
+//===============================================================================
+// JoystickState::released
+//===============================================================================
+
+inline bool JoystickState::released (int button) const {
+    return m_released & bit (button);
+}
+
+//===============================================================================
+// JoystickState::buttons
+//===============================================================================
+
+inline uint32_t JoystickState::buttons() const {
+    return m_buttons;
+}
+
+//===============================================================================
+// JoystickState::bit
+//===============================================================================
+
+inline uint32_t JoystickState::bit (int button) {
+    return button >= 1 && button <= 32 ? 1u << (button - 1) : 0;
+}
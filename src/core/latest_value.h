@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+///
+/// Lock-free slot holding the latest value written by one thread, for one
+/// reader thread (a triple buffer).
+///
+/// The writer never waits for the reader and the reader never sees a value
+/// that is being written: each side owns one of the three copies, and the
+/// third one is swapped atomically with them.
+///
+template <typename T>
+class LatestValue {
+  public:
+    LatestValue() : m_back (0), m_middle (1), m_front (2), m_valid (false) {}
+
+    ///
+    /// (Writer) Publishes a new value
+    ///
+    void store (const T& value) {
+        m_values[m_back] = value;
+        m_back = m_middle.exchange (m_back | kFresh, std::memory_order_acq_rel) & kIndex;
+    }
+
+    ///
+    /// (Reader) Copies the latest value into \a value, returns false if no
+    /// value has been published yet
+    ///
+    bool load (T& value) {
+        if (m_middle.load (std::memory_order_relaxed) & kFresh) {
+            m_front = m_middle.exchange (m_front, std::memory_order_acq_rel) & kIndex;
+            m_valid = true;
+        }
+
+        if (m_valid)
+            value = m_values[m_front];
+
+        return m_valid;
+    }
+
+  private:
+    static const uint8_t kIndex = 0x03;
+    static const uint8_t kFresh = 0x04;
+
+    T m_values[3];
+
+    /* Keep the indices of each thread on a different cache line */
+    uint8_t m_back;
+    char m_writerPadding[64];
+    std::atomic<uint8_t> m_middle;
+    char m_readerPadding[64];
+    uint8_t m_front;
+    bool m_valid;
+};
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "loop_timing.h"
+
+#include <stdio.h>
+
+///
+/// Names of the sections, as shown in the dashboard
+///
+static const char* kSectionNames[LoopTiming::kSections] = {
+    "Odometry", "Hands", "Lifter", "Intake", "Shooter", "Powertrain", "Power",
+    "Outputs"
+};
+
+//===============================================================================
+// LoopTiming::LoopTiming
+//===============================================================================
+
+LoopTiming::LoopTiming() :
+    m_loop (100),
+    m_jitter (Timing::kJitterBucketUs),
+    m_overruns (0),
+    m_running (false),
+    m_stop (false) {}
+
+//===============================================================================
+// LoopTiming::~LoopTiming
+//===============================================================================
+
+LoopTiming::~LoopTiming() {
+    m_stop = true;
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+//===============================================================================
+// LoopTiming::start
+//===============================================================================
+
+///
+/// Starts publishing the summary, does nothing when the timing is disabled
+///
+void LoopTiming::start() {
+    if (ENABLE_LOOP_TIMING && !m_thread.joinable())
+        m_thread = std::thread (&LoopTiming::run, this);
+}
+
+//===============================================================================
+// LoopTiming::overruns
+//===============================================================================
+
+uint32_t LoopTiming::overruns() const {
+    return m_overruns.load (std::memory_order_relaxed);
+}
+
+//===============================================================================
+// LoopTiming::publish
+//===============================================================================
+
+///
+/// Sends the p50, p99 and maximum time of each section (in milliseconds) to
+/// the dashboard, and prints a summary of the whole loop
+///
+void LoopTiming::publish() {
+    for (int i = 0; i < kSections; ++i) {
+        const std::string name = std::string ("Timing ") + kSectionNames[i];
+        SD::PutNumber (name + " p50", m_sections[i].percentile (50) / 1000.0);
+        SD::PutNumber (name + " p99", m_sections[i].percentile (99) / 1000.0);
+        SD::PutNumber (name + " max", m_sections[i].max() / 1000.0);
+    }
+
+    SD::PutNumber ("Timing Loop p99", m_loop.percentile (99) / 1000.0);
+    SD::PutNumber ("Timing Loop max", m_loop.max() / 1000.0);
+    SD::PutNumber ("Timing Jitter p99", m_jitter.percentile (99) / 1000.0);
+    SD::PutNumber ("Timing Overruns", overruns());
+
+    if (m_loop.count() == 0)
+        return;
+
+    printf ("Loop: %u loops, p50 %.2f ms, p99 %.2f ms, max %.2f ms, "
+            "jitter p99 %.2f ms, %u overruns\n",
+            m_loop.count(),
+            m_loop.percentile (50) / 1000.0,
+            m_loop.percentile (99) / 1000.0,
+            m_loop.max() / 1000.0,
+            m_jitter.percentile (99) / 1000.0,
+            overruns());
+}
+
+//===============================================================================
+// LoopTiming::run
+//===============================================================================
+
+void LoopTiming::run() {
+    const std::chrono::milliseconds period (Timing::kSummaryPeriodMs);
+    Clock::time_point next = Clock::now() + period;
+
+    while (!m_stop) {
+        std::this_thread::sleep_for (std::chrono::milliseconds (10));
+        if (Clock::now() < next)
+            continue;
+
+        publish();
+        next += period;
+    }
+}
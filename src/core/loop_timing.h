@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+
+#include "core/common.h"
+#include "core/histogram.h"
+
+///
+/// Measures how long each part of the control loop (see ControlLoop) takes,
+/// how much its period jitters and how many cycles take longer than the
+/// period.
+///
+/// The control loop calls beginLoop(), then lap() after each subsystem and
+/// endLoop() at the end. Each call only reads the monotonic clock and adds
+/// a sample to a lock-free histogram. A background thread publishes a
+/// summary to the dashboard (and the console) every second.
+///
+/// Everything is disabled when ENABLE_LOOP_TIMING is false: the calls are
+/// inlined and become empty, and no thread is started.
+///
+class LoopTiming {
+  public:
+    enum Section {
+        kOdometry,
+        kHands,
+        kLifter,
+        kIntake,
+        kShooter,
+        kPowertrain,
+        kPower,
+        kOutputs,
+        kSections,
+    };
+
+    explicit LoopTiming();
+    ~LoopTiming();
+
+    void start();
+
+    inline void beginLoop();
+    inline void lap (Section section);
+    inline void endLoop();
+
+    uint32_t overruns() const;
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    static uint32_t micros (Clock::time_point from, Clock::time_point to);
+
+    void publish();
+    void run();
+
+    Histogram m_sections[kSections];
+    Histogram m_loop;
+    Histogram m_jitter;
+    std::atomic<uint32_t> m_overruns;
+
+    Clock::time_point m_loopStart;
+    Clock::time_point m_lapStart;
+    bool m_running;
+
+    std::atomic<bool> m_stop;
+    std::thread m_thread;
+};
+
+//===============================================================================
+// LoopTiming::beginLoop
+//===============================================================================
+
+///
+/// Marks the start of a loop, and measures the difference between the time
+/// since the previous loop and the loop period (pauses longer than a second,
+/// such as mode changes, are ignored)
+///
+inline void LoopTiming::beginLoop() {
+    if (!ENABLE_LOOP_TIMING)
+        return;
+
+    const Clock::time_point now = Clock::now();
+    if (m_running) {
+        const int64_t period = micros (m_loopStart, now);
+        if (period < Timing::kMaxPeriodUs)
+            m_jitter.add ((uint32_t) llabs (period - Timing::kLoopBudgetUs));
+    }
+
+    m_loopStart = m_lapStart = now;
+    m_running = true;
+}
+
+//===============================================================================
+// LoopTiming::lap
+//===============================================================================
+
+///
+/// Adds the time since the previous lap (or since the start of the loop) to
+/// the given section
+///
+inline void LoopTiming::lap (Section section) {
+    if (!ENABLE_LOOP_TIMING)
+        return;
+
+    const Clock::time_point now = Clock::now();
+    m_sections[section].add (micros (m_lapStart, now));
+    m_lapStart = now;
+}
+
+//===============================================================================
+// LoopTiming::endLoop
+//===============================================================================
+
+///
+/// Measures the whole loop, and counts it as an overrun if it took longer
+/// than the loop period
+///
+inline void LoopTiming::endLoop() {
+    if (!ENABLE_LOOP_TIMING)
+        return;
+
+    const uint32_t elapsed = micros (m_loopStart, Clock::now());
+    m_loop.add (elapsed);
+
+    if (elapsed > Timing::kLoopBudgetUs)
+        m_overruns.fetch_add (1, std::memory_order_relaxed);
+}
+
+//===============================================================================
+// LoopTiming::micros
+//===============================================================================
+
+inline uint32_t LoopTiming::micros (Clock::time_point from, Clock::time_point to) {
+    return (uint32_t) std::chrono::duration_cast<std::chrono::microseconds> (to - from).count();
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "output_frame.h"
+
+//===============================================================================
+// OutputFrame::OutputFrame
+//===============================================================================
+
+OutputFrame::OutputFrame() : m_writes (0), m_skipped (0) {
+    for (int i = 0; i < kChannels; ++i) {
+        m_controllers[i] = nullptr;
+        m_staged[i].init (this, (Channel) i);
+        m_values[i] = 0;
+        m_scales[i] = 1;
+        m_sent[i] = 0;
+        m_sentTime[i] = 0;
+    }
+}
+
+//===============================================================================
+// OutputFrame::attach
+//===============================================================================
+
+///
+/// Sets the speed controller that receives the output of the given channel,
+/// the channel is not written while its controller is nullptr
+///
+void OutputFrame::attach (Channel channel, SpeedController* controller) {
+    m_controllers[channel] = controller;
+    m_sentTime[channel] = -kKeepAlivePeriod;
+}
+
+//===============================================================================
+// OutputFrame::staged
+//===============================================================================
+
+///
+/// Returns a speed controller that writes to the given channel of the frame
+///
+SpeedController* OutputFrame::staged (Channel channel) {
+    return &m_staged[channel];
+}
+
+//===============================================================================
+// OutputFrame::set
+//===============================================================================
+
+void OutputFrame::set (Channel channel, float value) {
+    m_values[channel] = value;
+}
+
+//===============================================================================
+// OutputFrame::get
+//===============================================================================
+
+float OutputFrame::get (Channel channel) const {
+    return m_values[channel];
+}
+
+//===============================================================================
+// OutputFrame::setScale
+//===============================================================================
+
+void OutputFrame::setScale (Channel channel, float scale) {
+    m_scales[channel] = scale;
+}
+
+//===============================================================================
+// OutputFrame::scale
+//===============================================================================
+
+float OutputFrame::scale (Channel channel) const {
+    return m_scales[channel];
+}
+
+//===============================================================================
+// OutputFrame::flush
+//===============================================================================
+
+///
+/// Writes the channels that changed (or that need to be refreshed) to their
+/// speed controllers, multiplied by their scale
+///
+void OutputFrame::flush() {
+    const double now = Timer::GetFPGATimestamp();
+
+    for (int i = 0; i < kChannels; ++i) {
+        if (!m_controllers[i])
+            continue;
+
+        const float value = m_values[i] * m_scales[i];
+        if (value == m_sent[i] && now - m_sentTime[i] < kKeepAlivePeriod) {
+            ++m_skipped;
+            continue;
+        }
+
+        m_controllers[i]->Set (value);
+        m_sent[i] = value;
+        m_sentTime[i] = now;
+        ++m_writes;
+    }
+}
+
+//===============================================================================
+// OutputFrame::resend
+//===============================================================================
+
+///
+/// Forces the next flush to write every channel, this is needed when the
+/// robot is enabled, because the controllers are disabled with the robot
+///
+void OutputFrame::resend() {
+    for (int i = 0; i < kChannels; ++i)
+        m_sentTime[i] = -kKeepAlivePeriod;
+}
+
+//===============================================================================
+// OutputFrame::writes
+//===============================================================================
+
+uint32_t OutputFrame::writes() const {
+    return m_writes;
+}
+
+//===============================================================================
+// OutputFrame::skipped
+//===============================================================================
+
+uint32_t OutputFrame::skipped() const {
+    return m_skipped;
+}
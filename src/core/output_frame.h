@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "core/common.h"
+
+///
+/// Motor outputs of a control cycle, written to the speed controllers all
+/// at once at the end of the cycle.
+///
+/// Subsystems set the output of their channels (directly, or through the
+/// staged() controllers given to RobotDrive) as many times as they want,
+/// but nothing is sent until flush() is called. A channel is only written
+/// to its controller when its value changed since the last flush, or when
+/// it has not been written for kKeepAlivePeriod, so that a steady output
+/// does not use the CAN bus on every loop.
+///
+/// Each channel also has a scale (1 by default), by which its value is
+/// multiplied when it is written (see PowerBudget).
+///
+/// The values are stored as arrays (one entry per channel) so that flush()
+/// is a single pass over a few cache lines.
+///
+class OutputFrame {
+  public:
+    enum Channel {
+        kLeftA,
+        kLeftB,
+        kRightA,
+        kRightB,
+        kClutchA,
+        kClutchB,
+        kShooterLeft,
+        kShooterRight,
+        kIntake,
+        kChannels,
+    };
+
+    ///
+    /// Maximum time between two writes of the same value, must be lower than
+    /// the expiration time of the motor safety helpers (0.1 s)
+    ///
+    static constexpr double kKeepAlivePeriod = 0.05;
+
+    explicit OutputFrame();
+
+    void attach (Channel channel, SpeedController* controller);
+    SpeedController* staged (Channel channel);
+
+    void set (Channel channel, float value);
+    float get (Channel channel) const;
+
+    void setScale (Channel channel, float scale);
+    float scale (Channel channel) const;
+
+    void flush();
+    void resend();
+
+    uint32_t writes() const;
+    uint32_t skipped() const;
+
+  private:
+    ///
+    /// Speed controller that stages its output in the frame, this allows us
+    /// to keep using RobotDrive. The frame holds one for each channel.
+    ///
+    class StagedController : public SpeedController {
+      public:
+        StagedController() : m_frame (nullptr), m_channel (kLeftA) {}
+
+        void init (OutputFrame* frame, Channel channel) {
+            m_frame = frame;
+            m_channel = channel;
+        }
+
+        void Set (float speed, uint8_t syncGroup = 0) override {
+            (void) syncGroup;
+            m_frame->set (m_channel, speed);
+        }
+
+        float Get() const override {
+            return m_frame->get (m_channel);
+        }
+
+        void SetInverted (bool isInverted) override {
+            if (controller())
+                controller()->SetInverted (isInverted);
+        }
+
+        bool GetInverted() const override {
+            return controller() ? controller()->GetInverted() : false;
+        }
+
+        /* A detached channel belongs to someone else, only the frame is reset */
+        void Disable() override {
+            m_frame->set (m_channel, 0);
+            if (controller())
+                controller()->Disable();
+        }
+
+        void PIDWrite (float output) override {
+            Set (output);
+        }
+
+      private:
+        SpeedController* controller() const {
+            return m_frame->m_controllers[m_channel];
+        }
+
+        OutputFrame* m_frame;
+        Channel m_channel;
+    };
+
+    SpeedController* m_controllers[kChannels];
+    StagedController m_staged[kChannels];
+
+    float m_values[kChannels];
+    float m_scales[kChannels];
+    float m_sent[kChannels];
+    double m_sentTime[kChannels];
+
+    uint32_t m_writes;
+    uint32_t m_skipped;
+};
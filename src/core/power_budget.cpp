@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "power_budget.h"
+
+///
+/// Consumer of each channel of the output frame. The flywheels run a speed
+/// closed loop, so their channels hold a target speed that must not be
+/// scaled (kConsumers): the shooter applies its own scale (see Shooter::limit).
+///
+static const PowerBudget::Consumer kChannelConsumers[OutputFrame::kChannels] = {
+    PowerBudget::kDrive,
+    PowerBudget::kDrive,
+    PowerBudget::kDrive,
+    PowerBudget::kDrive,
+    PowerBudget::kDrive,
+    PowerBudget::kDrive,
+    PowerBudget::kConsumers,
+    PowerBudget::kConsumers,
+    PowerBudget::kIntake,
+};
+
+//===============================================================================
+// PowerBudget::PowerBudget
+//===============================================================================
+
+PowerBudget::PowerBudget (OutputFrame* outputs) :
+    m_outputs (outputs),
+    m_voltage (0) {
+    for (int i = 0; i < kConsumers; ++i)
+        m_scales[i] = 1;
+}
+
+//===============================================================================
+// PowerBudget::update
+//===============================================================================
+
+///
+/// Computes the scale of each consumer and applies it to its channels. The
+/// current a consumer asks for is estimated from the current it draws with
+/// its current scale.
+///
+void PowerBudget::update (const float (&currents)[kConsumers]) {
+    m_voltage = m_pdp.GetVoltage();
+
+    float available = (m_voltage - Power::kMinVoltage) / Power::kResistance;
+    for (int i = 0; i < kConsumers; ++i)
+        available += currents[i];
+
+    for (int i = 0; i < kConsumers; ++i) {
+        const float demand = currents[i] / fmaxf (m_scales[i], Power::kMinScale);
+        const float granted = fminf (demand, fmaxf (available, 0));
+        const float target = demand > 0 ? granted / demand : 1;
+        available -= granted;
+
+        if (target < m_scales[i])
+            m_scales[i] = target;
+        else
+            m_scales[i] = fminf (target, m_scales[i] + Power::kRecoveryRate);
+    }
+
+    for (int i = 0; i < OutputFrame::kChannels; ++i) {
+        if (kChannelConsumers[i] != kConsumers)
+            m_outputs->setScale ((OutputFrame::Channel) i, m_scales[kChannelConsumers[i]]);
+    }
+}
+
+//===============================================================================
+// PowerBudget::scale
+//===============================================================================
+
+float PowerBudget::scale (Consumer consumer) const {
+    return m_scales[consumer];
+}
+
+//===============================================================================
+// PowerBudget::voltage
+//===============================================================================
+
+///
+/// Returns the voltage of the battery measured by the last update
+///
+float PowerBudget::voltage() const {
+    return m_voltage;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "core/common.h"
+#include "core/output_frame.h"
+
+///
+/// Shares the current that the battery can give among the motors, so that
+/// its voltage does not drop low enough to brown out the robot.
+///
+/// The control loop calls update() once per cycle, after the subsystems have
+/// set their outputs and before the frame is flushed, with the current drawn
+/// by the motors of each consumer (as measured by their Talons). The current
+/// they can draw without taking the battery under Power::kMinVoltage is
+/// estimated from the voltage measured by the PDP and given to the consumers
+/// in order of priority. When a consumer gets less than it asks for, its
+/// scale drops at once and goes back up by Power::kRecoveryRate per cycle.
+/// The outputs of the drive and intake channels are multiplied by their
+/// scale (see OutputFrame::setScale), the shooter limits its flywheels with
+/// the scale of kShooter (see Shooter::limit).
+///
+/// The work is a fixed number of operations per consumer and channel.
+///
+class PowerBudget {
+  public:
+    enum Consumer {
+        kDrive,
+        kShooter,
+        kIntake,
+        kConsumers,
+    };
+
+    explicit PowerBudget (OutputFrame* outputs);
+
+    void update (const float (&currents)[kConsumers]);
+
+    float scale (Consumer consumer) const;
+    float voltage() const;
+
+  private:
+    OutputFrame* m_outputs;
+    PowerDistributionPanel m_pdp;
+
+    float m_scales[kConsumers];
+    float m_voltage;
+};
@@ -22,67 +22,349 @@
 
 #include "robot.h"
 
+//===============================================================================
+// Robot::Robot
+//===============================================================================
+
+Robot::Robot() :
+    m_budget (&m_outputs),
+    m_subsystemIntake (&m_outputs),
+    m_subsystemShooter (&m_outputs),
+    m_subsystemPowertrain (&m_outputs),
+    m_odometry (&m_subsystemPowertrain),
+    m_autoAim (&m_subsystemVision, &m_subsystemPowertrain, &m_odometry),
+    m_autonomous (&m_subsystemPowertrain),
+    m_sequencer (&m_autonomous, &m_subsystemShooter, &m_subsystemIntake, &m_subsystemLifter),
+    m_mode (-1),
+    m_values(),
+    m_control (std::bind (&Robot::control, this, std::placeholders::_1,
+                          std::placeholders::_2)) {}
+
 //===============================================================================
 // Robot::RobotInit
 //===============================================================================
 
+///
+/// Loads the autonomous routine and starts the background threads
+///
 void Robot::RobotInit() {
-    m_timer               = new Timer();
-    m_subsystemHands      = new Hands();
-    m_subsystemLifter     = new Lifter();
-    m_subsystemIntake     = new Intake();
-    m_subsystemShooter    = new Shooter();
-    m_subsystemPowertrain = new Powertrain();
-    m_driveJoystick       = new Joystick (0);
-    m_secndJoystick       = new Joystick (1);
-
-    CameraServer::GetInstance()->StartAutomaticCapture ("cam0");
+    const char* routine = getenv ("KZ_ROUTINE");
+    m_sequencer.load (routine ? routine : Routines::kPath);
+
+    m_subsystemVision.start();
+    m_timing.start();
+    m_recorder.start();
+    m_control.start();
+}
+
+//===============================================================================
+// Robot::stop
+//===============================================================================
+
+///
+/// Stops the control loop and the vision threads once the competition has
+/// ended (see main.cpp), before the static objects of the program (such as
+/// the frames of the simulated camera) are destroyed
+///
+void Robot::stop() {
+    m_control.stop();
+    m_subsystemVision.stop();
 }
 
 //===============================================================================
-// Robot::TeleopInit
+// Robot::TeleopPeriodic
 //===============================================================================
 
-void Robot::TeleopInit() {
-    m_timer->Stop();
+///
+/// The Periodic functions only hand the driver station packet to the control
+/// loop, which runs the subsystems (see Robot::control), and show the pose
+/// and the values it published on the dashboard
+///
+void Robot::TeleopPeriodic() {
+    m_control.publish (DriverPacket::kTeleop);
     putDashboardValues();
+    putPose();
 }
 
 //===============================================================================
-// Robot::DisabledInit
+// Robot::DisabledPeriodic
 //===============================================================================
 
-void Robot::DisabledInit() {
-    m_timer->Stop();
+void Robot::DisabledPeriodic() {
+    m_control.publish (DriverPacket::kDisabled);
     putDashboardValues();
+    putPose();
 }
 
 //===============================================================================
-// Robot::AutonomousInit
+// Robot::AutonomousPeriodic
 //===============================================================================
 
-void Robot::AutonomousInit() {
-    m_timer->Reset();
-    m_timer->Start();
+void Robot::AutonomousPeriodic() {
+    m_control.publish (DriverPacket::kAutonomous);
+    putDashboardValues();
+    putPose();
 }
 
 //===============================================================================
-// Robot::TeleopPeriodic
+// Robot::control
 //===============================================================================
 
-void Robot::TeleopPeriodic() {
-    m_subsystemHands->move       (*m_secndJoystick);
-    m_subsystemLifter->move      (*m_secndJoystick);
-    m_subsystemIntake->move      (*m_secndJoystick);
-    m_subsystemShooter->shoot    (*m_secndJoystick);
-    m_subsystemPowertrain->drive (m_driveJoystick, m_secndJoystick);
+///
+/// Runs a cycle of the control loop: enters the mode of the packet when it
+/// changed, updates the pose and the subsystems, shares the power of the
+/// battery among them and sends their outputs.
+/// Each packet is recorded once, after the first cycle that used it. The
+/// pose is also updated while the robot is disabled, as it can be pushed.
+///
+void Robot::control (const DriverPacket& packet, bool fresh) {
+    if (packet.mode != m_mode) {
+        m_mode = packet.mode;
+        enter ((DriverPacket::Mode) m_mode);
+    }
+
+    if (m_mode == DriverPacket::kDisabled) {
+        m_odometry.update();
+        return;
+    }
+
+    m_timing.beginLoop();
+    m_odometry.update();
+    m_timing.lap (LoopTiming::kOdometry);
+    m_inputs.update (packet);
+
+    if (m_mode == DriverPacket::kTeleop)
+        teleop();
+    else
+        autonomous();
+
+    const float currents[PowerBudget::kConsumers] = {
+        m_subsystemPowertrain.current(),
+        m_subsystemShooter.current(),
+        m_subsystemIntake.current(),
+    };
+
+    m_budget.update (currents);
+    m_subsystemShooter.limit (m_budget.scale (PowerBudget::kShooter));
+    m_timing.lap (LoopTiming::kPower);
+    m_outputs.flush();
+    m_timing.lap (LoopTiming::kOutputs);
+
+    if (fresh) {
+        record (m_mode == DriverPacket::kTeleop ? TelemetryRecord::kTeleop :
+                TelemetryRecord::kAutonomous, packet);
+    }
+
+    m_timing.endLoop();
 }
 
 //===============================================================================
-// Robot::AutonomousPeriodic
+// Robot::enter
 //===============================================================================
 
-void Robot::AutonomousPeriodic() {
-    if (m_timer->Get() < 7)
-        m_subsystemPowertrain->drive (0, 0.75, 0, true);
-}
\ No newline at end of file
+void Robot::enter (DriverPacket::Mode mode) {
+    switch (mode) {
+        case DriverPacket::kDisabled:
+            m_timer.Stop();
+            m_sequencer.stop();
+            gatherDashboardValues();
+            break;
+        case DriverPacket::kAutonomous:
+            m_timer.Reset();
+            m_timer.Start();
+            m_odometry.reset();
+            m_outputs.resend();
+            m_sequencer.start();
+            break;
+        case DriverPacket::kTeleop:
+            m_timer.Stop();
+            m_sequencer.stop();
+            m_outputs.resend();
+            gatherDashboardValues();
+            break;
+    }
+}
+
+//===============================================================================
+// Robot::teleop
+//===============================================================================
+
+void Robot::teleop() {
+    m_subsystemHands.move       (m_inputs.second);
+    m_timing.lap                (LoopTiming::kHands);
+    m_subsystemLifter.move      (m_inputs.second);
+    m_subsystemLifter.update    (motorCurrent());
+    m_timing.lap                (LoopTiming::kLifter);
+    m_subsystemIntake.move      (m_inputs.second);
+    m_timing.lap                (LoopTiming::kIntake);
+    m_subsystemShooter.shoot    (m_inputs.second);
+    m_timing.lap                (LoopTiming::kShooter);
+
+    /* The auto-aim takes over the rotation while its button is held */
+    m_autoAim.track();
+    if (m_inputs.drive.button (OI::kAutoAimButton)) {
+        if (m_inputs.drive.pressed (OI::kAutoAimButton))
+            m_autoAim.reset();
+
+        m_autoAim.aim (m_inputs.drive);
+    }
+
+    else
+        m_subsystemPowertrain.drive (m_inputs.drive, m_inputs.second);
+
+    updateIndicators();
+    m_timing.lap                (LoopTiming::kPowertrain);
+}
+
+//===============================================================================
+// Robot::autonomous
+//===============================================================================
+
+void Robot::autonomous() {
+    /* The drive motors are written by the profile follower, not the frame */
+    m_sequencer.run();
+    m_subsystemLifter.update (motorCurrent());
+    updateIndicators();
+    m_timing.lap (LoopTiming::kPowertrain);
+}
+
+//===============================================================================
+// Robot::motorCurrent
+//===============================================================================
+
+///
+/// Returns the current drawn by the motors that can brown out the robot
+///
+float Robot::motorCurrent() const {
+    return m_subsystemPowertrain.current() + m_subsystemShooter.current();
+}
+
+//===============================================================================
+// Robot::gatherDashboardValues
+//===============================================================================
+
+///
+/// Publishes the state of the vision, the CAN bus, the autonomous routine and
+/// the compressor for the dashboard, called when a mode is entered
+///
+void Robot::gatherDashboardValues() {
+    VisionResult vision;
+    m_values.visionReady    = m_subsystemVision.latest (vision);
+    m_values.visionTargets  = m_values.visionReady ? vision.report.count : 0;
+    m_values.canWrites      = m_outputs.writes();
+    m_values.canSkipped     = m_outputs.skipped();
+    m_values.autoMaxError   = m_autonomous.maxError();
+    m_values.compressorAuto = m_subsystemLifter.compressorAutomatic();
+    m_dashboard.store (m_values);
+}
+
+//===============================================================================
+// Robot::updateIndicators
+//===============================================================================
+
+///
+/// Publishes the ready, aligned, compressor and telemetry indicators for the
+/// dashboard, only when one of them changed
+///
+void Robot::updateIndicators() {
+    const bool ready = m_subsystemShooter.readyToFire();
+    const bool aligned = m_autoAim.aligned();
+    const bool compressorAuto = m_subsystemLifter.compressorAutomatic();
+    const bool failed = m_recorder.failed();
+
+    if (ready != m_values.shooterReady || aligned != m_values.aimAligned ||
+        compressorAuto != m_values.compressorAuto || failed != m_values.telemetryFailed) {
+        m_values.shooterReady = ready;
+        m_values.aimAligned = aligned;
+        m_values.compressorAuto = compressorAuto;
+        m_values.telemetryFailed = failed;
+        m_dashboard.store (m_values);
+    }
+}
+
+//===============================================================================
+// Robot::putDashboardValues
+//===============================================================================
+
+///
+/// (Packet loop) Shows the latest values published by the control loop on
+/// the dashboard
+///
+void Robot::putDashboardValues() {
+    DashboardValues values;
+    if (!m_dashboard.load (values))
+        return;
+
+    SD::PutBoolean ("Vision Ready", values.visionReady);
+    SD::PutNumber  ("Vision Targets", values.visionTargets);
+    SD::PutNumber  ("CAN Writes", values.canWrites);
+    SD::PutNumber  ("CAN Skipped", values.canSkipped);
+    SD::PutNumber  ("Auto Max Error", values.autoMaxError);
+    SD::PutBoolean ("Shooter Ready", values.shooterReady);
+    SD::PutBoolean ("Aim Aligned", values.aimAligned);
+    SD::PutBoolean ("Compressor Auto", values.compressorAuto);
+    SD::PutBoolean ("Telemetry Error", values.telemetryFailed);
+}
+
+//===============================================================================
+// Robot::putPose
+//===============================================================================
+
+///
+/// (Packet loop) Shows the latest pose of the robot on the dashboard
+///
+void Robot::putPose() {
+    Pose pose;
+    if (m_odometry.latest (pose)) {
+        SD::PutNumber ("Pose X", pose.x);
+        SD::PutNumber ("Pose Y", pose.y);
+        SD::PutNumber ("Pose Heading", pose.heading);
+    }
+}
+
+//===============================================================================
+// Robot::record
+//===============================================================================
+
+///
+/// Saves the inputs of the loop and the outputs sent to the actuators
+///
+void Robot::record (TelemetryRecord::Mode mode, const DriverPacket& packet) {
+    static_assert (TelemetryRecord::kMotors == OutputFrame::kChannels + 2,
+                   "Every motor must have its place in the telemetry");
+    static_assert (TelemetryRecord::kAxes == JoystickState::kAxes,
+                   "Every axis must have its place in the telemetry");
+
+    const char* controllers[TelemetryRecord::kJoysticks];
+    for (int i = 0; i < TelemetryRecord::kJoysticks; ++i)
+        controllers[i] = packet.profiles[i]->name;
+
+    TelemetryRecord* record = m_recorder.claim (controllers);
+    if (!record)
+        return;
+
+    const JoystickState* joysticks[] = { &m_inputs.drive, &m_inputs.second };
+    for (int i = 0; i < TelemetryRecord::kJoysticks; ++i) {
+        record->buttons[i] = joysticks[i]->buttons();
+        for (int j = 0; j < TelemetryRecord::kAxes; ++j)
+            record->axes[i][j] = joysticks[i]->axis (j);
+    }
+
+    for (int i = 0; i < OutputFrame::kChannels; ++i)
+        record->motors[i] = m_outputs.get ((OutputFrame::Channel) i);
+
+    record->motors[OutputFrame::kChannels]     = m_subsystemHands.output();
+    record->motors[OutputFrame::kChannels + 1] = m_subsystemShooter.actuator();
+
+    record->time       = Timer::GetFPGATimestamp();
+    record->mode       = mode;
+    record->timer      = m_timer.Get();
+    record->range      = m_subsystemShooter.range();
+    record->solenoid   = m_subsystemLifter.solenoid();
+    record->compressor = m_subsystemLifter.compressorEnabled();
+    record->x          = m_odometry.pose().x;
+    record->y          = m_odometry.pose().y;
+    record->heading    = m_odometry.pose().heading;
+
+    m_recorder.publish();
+}
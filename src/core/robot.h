@@ -23,32 +23,94 @@
 #pragma once
 
 #include "common.h"
+#include "inputs.h"
+#include "control_loop.h"
+#include "latest_value.h"
+#include "loop_timing.h"
+#include "output_frame.h"
+#include "power_budget.h"
+#include "telemetry.h"
 #include "subsystems/hands.h"
+#include "subsystems/auto_aim.h"
+#include "subsystems/odometry.h"
+#include "subsystems/autonomous.h"
+#include "subsystems/sequencer.h"
 #include "subsystems/lifter.h"
 #include "subsystems/intake.h"
 #include "subsystems/shooter.h"
+#include "subsystems/vision.h"
 #include "subsystems/powertrain.h"
 
+///
+/// Every subsystem and piece of hardware of the robot is a member of this
+/// class (not a pointer), so the whole robot is a single block of memory
+/// that is allocated once (see main.cpp). The members are constructed in the
+/// order in which they are declared and destroyed in the reverse order: the
+/// control loop is stopped first and the telemetry log is closed after the
+/// last record.
+///
 class Robot : public IterativeRobot {
   public:
+    explicit Robot();
+
     void RobotInit();
-    void TeleopInit();
-    void DisabledInit();
-    void AutonomousInit();
+    void stop();
     void TeleopPeriodic();
+    void DisabledPeriodic();
     void AutonomousPeriodic();
 
   private:
-    Timer* m_timer;
+    ///
+    /// Values shown on the dashboard, gathered by the control loop and
+    /// written by the packet loop (the dashboard takes locks and allocates)
+    ///
+    struct DashboardValues {
+        bool visionReady;
+        int visionTargets;
+        uint32_t canWrites;
+        uint32_t canSkipped;
+        double autoMaxError;
+        bool shooterReady;
+        bool aimAligned;
+        bool compressorAuto;
+        bool telemetryFailed;
+    };
+
+    void control (const DriverPacket& packet, bool fresh);
+    void enter (DriverPacket::Mode mode);
+    void teleop();
+    void autonomous();
+    float motorCurrent() const;
+    void gatherDashboardValues();
+    void updateIndicators();
+    void putDashboardValues();
+    void putPose();
+    void record (TelemetryRecord::Mode mode, const DriverPacket& packet);
+
+    Timer m_timer;
+    LoopTiming m_timing;
+    OutputFrame m_outputs;
+    PowerBudget m_budget;
+    TelemetryRecorder m_recorder;
+
+    Hands m_subsystemHands;
+    Lifter m_subsystemLifter;
+    Intake m_subsystemIntake;
+    Shooter m_subsystemShooter;
+    Vision m_subsystemVision;
+    Powertrain m_subsystemPowertrain;
+    Odometry m_odometry;
+    AutoAim m_autoAim;
+    Autonomous m_autonomous;
+    Sequencer m_sequencer;
+
+    InputSnapshot m_inputs;
+    int m_mode;
 
-    Hands* m_subsystemHands;
-    Lifter* m_subsystemLifter;
-    Intake* m_subsystemIntake;
-    Shooter* m_subsystemShooter;
-    Powertrain* m_subsystemPowertrain;
+    DashboardValues m_values;
+    LatestValue<DashboardValues> m_dashboard;
 
-    Joystick* m_driveJoystick;
-    Joystick* m_secndJoystick;
+    ControlLoop m_control;
 };
 
 
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "routine.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char kMagic[8] = { 'K', 'Z', 'R', 'O', 'U', 'T', 'I', 'N' };
+static const uint32_t kVersion = 1;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t commandSize;
+    uint32_t count;
+};
+
+static_assert (sizeof (RoutineCommand) == 12, "Routine files must keep their layout");
+
+//===============================================================================
+// RoutineFile::name
+//===============================================================================
+
+///
+/// Returns the name of a command type, as written in the text routines
+///
+const char* RoutineFile::name (int type) {
+    static const char* kNames[RoutineCommand::kTypes] = {
+        "drive", "turn", "spin", "feed", "intake", "lift", "wait"
+    };
+
+    return type >= 0 && type < RoutineCommand::kTypes ? kNames[type] : nullptr;
+}
+
+//===============================================================================
+// RoutineFile::validate
+//===============================================================================
+
+///
+/// Checks that every command can run: the types are known, the values are
+/// finite numbers, the timed commands have a duration, the drives and turns
+/// are short enough for a motion profile and a group does not drive the
+/// robot twice (there is only one drivetrain)
+///
+bool RoutineFile::validate (const RoutineCommand* commands, int count) {
+    if (count < 0 || count > kMaxCommands)
+        return false;
+
+    int drives = 0;
+    for (int i = 0; i < count; ++i) {
+        const RoutineCommand& command = commands[i];
+        if (command.type >= RoutineCommand::kTypes || command.timeout < 0)
+            return false;
+
+        if (!isfinite (command.value) || !isfinite (command.timeout))
+            return false;
+
+        if (command.type == RoutineCommand::kDrive && fabsf (command.value) > kMaxDistance)
+            return false;
+
+        if (command.type == RoutineCommand::kTurn && fabsf (command.value) > kMaxAngle)
+            return false;
+
+        const bool timed = command.type >= RoutineCommand::kFeed;
+        if (timed && command.timeout <= 0)
+            return false;
+
+        drives += command.type == RoutineCommand::kDrive || command.type == RoutineCommand::kTurn;
+        if (drives > 1)
+            return false;
+
+        if (!(command.flags & RoutineCommand::kWithNext))
+            drives = 0;
+    }
+
+    return count == 0 || !(commands[count - 1].flags & RoutineCommand::kWithNext);
+}
+
+//===============================================================================
+// RoutineFile::read
+//===============================================================================
+
+///
+/// Reads a routine into \a commands (which must hold kMaxCommands), returns
+/// false if the file cannot be read, was written by an incompatible version
+/// of the program or is not valid
+///
+bool RoutineFile::read (const char* path, RoutineCommand* commands, int& count) {
+    count = 0;
+
+    FILE* file = fopen (path, "rb");
+    if (!file)
+        return false;
+
+    Header header;
+    bool valid = fread (&header, sizeof (header), 1, file) == 1 &&
+                 memcmp (header.magic, kMagic, sizeof (kMagic)) == 0 &&
+                 header.version == kVersion &&
+                 header.commandSize == sizeof (RoutineCommand) &&
+                 header.count <= (uint32_t) kMaxCommands;
+
+    if (valid) {
+        valid = fread (commands, sizeof (RoutineCommand), header.count, file) == header.count &&
+                validate (commands, header.count);
+    }
+
+    fclose (file);
+    count = valid ? header.count : 0;
+    return valid;
+}
+
+//===============================================================================
+// RoutineFile::write
+//===============================================================================
+
+bool RoutineFile::write (const char* path, const RoutineCommand* commands, int count) {
+    if (!validate (commands, count))
+        return false;
+
+    FILE* file = fopen (path, "wb");
+    if (!file)
+        return false;
+
+    Header header;
+    memcpy (header.magic, kMagic, sizeof (kMagic));
+    header.version = kVersion;
+    header.commandSize = sizeof (RoutineCommand);
+    header.count = count;
+
+    bool written = fwrite (&header, sizeof (header), 1, file) == 1 &&
+                   fwrite (commands, sizeof (RoutineCommand), count, file) == (size_t) count;
+
+    return fclose (file) == 0 && written;
+}
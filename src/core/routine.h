@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+///
+/// A step of an autonomous routine (see Sequencer). The meaning of the
+/// value depends on the type of the command:
+///
+///     kDrive          Distance, in inches (negative is backwards)
+///     kTurn           Angle, in degrees (counterclockwise)
+///     kSpinShooter    Range of the shot, in inches (0 stops the wheels)
+///     kFeed           Output of the shooter actuator
+///     kIntake         Output of the intake (negative gives the ball)
+///     kLift           Direction of the lifter piston (positive is up)
+///     kWait           Not used
+///
+/// Drive, turn and spin end when the robot or the shooter reaches its
+/// goal, the other commands run for \c timeout seconds. A command with the
+/// kWithNext flag runs in parallel with the next one, so a group is a run
+/// of flagged commands followed by an unflagged one.
+///
+/// This file does not depend on WPILib, so that the routines can also be
+/// written by the tools.
+///
+struct RoutineCommand {
+    enum Type {
+        kDrive,
+        kTurn,
+        kSpinShooter,
+        kFeed,
+        kIntake,
+        kLift,
+        kWait,
+        kTypes,
+    };
+
+    enum Flags {
+        kWithNext = 0x01,
+    };
+
+    uint8_t type;
+    uint8_t flags;
+    uint16_t reserved;
+    float value;
+    float timeout;
+};
+
+///
+/// Binary routine file: a small header followed by the commands, exactly as
+/// they are stored in memory
+///
+namespace RoutineFile {
+const int kMaxCommands = 64;
+
+/* Longest drive (in inches) and turn (in degrees), their motion profiles
+   must fit in MotionProfile::kMaxPoints samples (10 s with the limits of
+   Profiles, in which the robot drives about 1040 inches or turns 3000 deg) */
+const float kMaxDistance = 1000;
+const float kMaxAngle = 1080;
+
+const char* name (int type);
+bool validate (const RoutineCommand* commands, int count);
+bool read (const char* path, RoutineCommand* commands, int& count);
+bool write (const char* path, const RoutineCommand* commands, int count);
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+
+///
+/// Fixed-size, lock-free ring buffer shared by exactly one producer thread
+/// and one consumer thread.
+///
+/// The elements are allocated with the ring and filled in place: the
+/// producer claims the next free element, writes it and publishes it, the
+/// consumer reads it and releases it. Nothing is copied or allocated by
+/// the ring itself.
+///
+template <typename T, size_t N>
+class SpscRing {
+    static_assert ((N & (N - 1)) == 0, "The size of the ring must be a power of two");
+
+  public:
+    SpscRing() : m_head (0), m_tail (0) {}
+
+    ///
+    /// Gives access to the elements before the threads are started, so that
+    /// their buffers can be allocated up-front
+    ///
+    T& slot (size_t index) {
+        return m_items[index % N];
+    }
+
+    ///
+    /// (Producer) Returns the element to write next, or nullptr when the
+    /// ring is full
+    ///
+    T* claim() {
+        const size_t head = m_head.load (std::memory_order_relaxed);
+        if (head - m_tail.load (std::memory_order_acquire) == N)
+            return nullptr;
+
+        return &m_items[head & (N - 1)];
+    }
+
+    ///
+    /// (Producer) Makes the claimed element visible to the consumer
+    ///
+    void publish() {
+        const size_t head = m_head.load (std::memory_order_relaxed);
+        m_head.store (head + 1, std::memory_order_release);
+    }
+
+    ///
+    /// (Consumer) Returns the oldest published element, or nullptr when the
+    /// ring is empty
+    ///
+    T* front() {
+        const size_t tail = m_tail.load (std::memory_order_relaxed);
+        if (tail == m_head.load (std::memory_order_acquire))
+            return nullptr;
+
+        return &m_items[tail & (N - 1)];
+    }
+
+    ///
+    /// (Consumer) Returns the newest published element and gives the older
+    /// ones back to the producer, their number is stored in \a skipped
+    ///
+    T* newest (size_t* skipped = nullptr) {
+        const size_t tail = m_tail.load (std::memory_order_relaxed);
+        const size_t head = m_head.load (std::memory_order_acquire);
+        if (tail == head)
+            return nullptr;
+
+        if (skipped)
+            *skipped = head - 1 - tail;
+
+        m_tail.store (head - 1, std::memory_order_release);
+        return &m_items[(head - 1) & (N - 1)];
+    }
+
+    ///
+    /// (Consumer) Gives the element returned by front() or newest() back to
+    /// the producer
+    ///
+    void release() {
+        const size_t tail = m_tail.load (std::memory_order_relaxed);
+        m_tail.store (tail + 1, std::memory_order_release);
+    }
+
+    static size_t capacity() {
+        return N;
+    }
+
+  private:
+    T m_items[N];
+
+    /* Keep the indices of each thread on a different cache line */
+    std::atomic<size_t> m_head;
+    char m_padding[64];
+    std::atomic<size_t> m_tail;
+};
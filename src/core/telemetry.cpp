@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "telemetry.h"
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+//===============================================================================
+// logPath
+//===============================================================================
+
+static std::string logPath (const std::string& directory, unsigned number) {
+    char name[32];
+    snprintf (name, sizeof (name), "telemetry-%05u.bin", number);
+    return directory + "/" + name;
+}
+
+//===============================================================================
+// nextLog
+//===============================================================================
+
+///
+/// Returns the number of the next log of the directory (one more than the
+/// highest one), and deletes the oldest logs so that the new one makes
+/// Telemetry::kKeepLogs
+///
+static unsigned nextLog (const std::string& directory) {
+    std::vector<unsigned> logs;
+    if (DIR* dir = opendir (directory.c_str())) {
+        while (const dirent* entry = readdir (dir)) {
+            unsigned number = 0;
+            int length = 0;
+            if (sscanf (entry->d_name, "telemetry-%u.bin%n", &number, &length) == 1 &&
+                length > 0 && entry->d_name[length] == 0)
+                logs.push_back (number);
+        }
+
+        closedir (dir);
+    }
+
+    std::sort (logs.begin(), logs.end());
+    for (size_t i = 0; i + Telemetry::kKeepLogs <= logs.size(); ++i)
+        remove (logPath (directory, logs[i]).c_str());
+
+    return logs.empty() ? 1 : logs.back() + 1;
+}
+
+//===============================================================================
+// TelemetryRecorder::TelemetryRecorder
+//===============================================================================
+
+TelemetryRecorder::TelemetryRecorder() :
+    m_file (nullptr),
+    m_controllers(),
+    m_named (false),
+    m_headerWritten (false),
+    m_loop (0),
+    m_failed (false),
+    m_written (0),
+    m_dropped (0),
+    m_stop (false) {
+    /* Touch the whole ring now, instead of during the first loops */
+    for (size_t i = 0; i < m_ring.capacity(); ++i)
+        memset (&m_ring.slot (i), 0, sizeof (TelemetryRecord));
+}
+
+//===============================================================================
+// TelemetryRecorder::~TelemetryRecorder
+//===============================================================================
+
+TelemetryRecorder::~TelemetryRecorder() {
+    m_stop = true;
+    if (m_thread.joinable())
+        m_thread.join();
+
+    if (m_file)
+        fclose (m_file);
+}
+
+//===============================================================================
+// TelemetryRecorder::start
+//===============================================================================
+
+///
+/// Creates the next log in the telemetry directory (which can be changed
+/// with the KZ_TELEMETRY_DIR environment variable) and starts writing to it.
+/// Nothing is recorded if the telemetry is disabled or the file cannot be
+/// created.
+///
+bool TelemetryRecorder::start() {
+    if (!ENABLE_TELEMETRY || m_file)
+        return false;
+
+    const char* directory = getenv ("KZ_TELEMETRY_DIR");
+    if (!directory)
+        directory = Telemetry::kDirectory;
+
+    m_path = logPath (directory, nextLog (directory));
+    m_file = fopen (m_path.c_str(), "wb");
+    if (!m_file) {
+        printf ("Telemetry: cannot create %s\n", m_path.c_str());
+        return false;
+    }
+
+    printf ("Telemetry: recording to %s\n", m_path.c_str());
+    m_thread = std::thread (&TelemetryRecorder::run, this);
+    return true;
+}
+
+//===============================================================================
+// TelemetryRecorder::claim
+//===============================================================================
+
+///
+/// Returns the record of the current loop, or nullptr if nothing is being
+/// recorded or the ring is full. The names of the controller profiles given
+/// with the first record go to the header of the log.
+///
+TelemetryRecord* TelemetryRecorder::claim (
+    const char* const (&controllers)[TelemetryRecord::kJoysticks]) {
+    if (!m_file || m_failed.load (std::memory_order_relaxed))
+        return nullptr;
+
+    /* Published with the first record, the writer reads them after it */
+    if (!m_named) {
+        std::copy (controllers, controllers + TelemetryRecord::kJoysticks, m_controllers);
+        m_named = true;
+    }
+
+    TelemetryRecord* record = m_ring.claim();
+    if (!record) {
+        m_dropped.fetch_add (1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    memset (record, 0, sizeof (*record));
+    record->loop = m_loop++;
+    return record;
+}
+
+//===============================================================================
+// TelemetryRecorder::publish
+//===============================================================================
+
+void TelemetryRecorder::publish() {
+    m_ring.publish();
+}
+
+//===============================================================================
+// TelemetryRecorder::failed
+//===============================================================================
+
+bool TelemetryRecorder::failed() const {
+    return m_failed.load (std::memory_order_relaxed);
+}
+
+//===============================================================================
+// TelemetryRecorder::written
+//===============================================================================
+
+uint32_t TelemetryRecorder::written() const {
+    return m_written.load (std::memory_order_relaxed);
+}
+
+//===============================================================================
+// TelemetryRecorder::dropped
+//===============================================================================
+
+uint32_t TelemetryRecorder::dropped() const {
+    return m_dropped.load (std::memory_order_relaxed);
+}
+
+//===============================================================================
+// TelemetryRecorder::run
+//===============================================================================
+
+///
+/// Writes the published records until the recorder is destroyed, or until a
+/// write fails
+///
+void TelemetryRecorder::run() {
+    bool writing = true;
+    while (!m_stop && writing) {
+        std::this_thread::sleep_for (std::chrono::milliseconds (Telemetry::kFlushPeriodMs));
+        writing = drain();
+    }
+
+    if (writing)
+        writing = drain();
+
+    if (!writing) {
+        printf ("Telemetry: cannot write %s, recording stopped\n", m_path.c_str());
+        m_failed = true;
+    }
+}
+
+//===============================================================================
+// TelemetryRecorder::drain
+//===============================================================================
+
+///
+/// Writes the published records to the file (after the header, for the first
+/// one), returns false if the file is not written completely
+///
+bool TelemetryRecorder::drain() {
+    uint32_t count = 0;
+    bool complete = true;
+
+    while (TelemetryRecord* record = m_ring.front()) {
+        if (!m_headerWritten) {
+            complete = TelemetryLog::writeHeader (m_file, m_controllers);
+            m_headerWritten = true;
+        }
+
+        complete = complete && fwrite (record, sizeof (*record), 1, m_file) == 1;
+        m_ring.release();
+        if (!complete)
+            break;
+
+        ++count;
+    }
+
+    if (count > 0) {
+        complete = fflush (m_file) == 0 && complete;
+        m_written.fetch_add (count, std::memory_order_relaxed);
+    }
+
+    return complete;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "core/common.h"
+#include "core/spsc_ring.h"
+#include "core/telemetry_log.h"
+
+///
+/// Records the inputs of every driver station packet, and the outputs of the
+/// first control cycle that used them, to a binary log (see TelemetryLog),
+/// which can be replayed in the simulation.
+///
+/// The robot loop claims a record, fills it and publishes it to a ring that
+/// is allocated with the recorder. A background thread writes the published
+/// records to the file, so the loop never waits for the disk. The ring can
+/// hold a whole match, if it is full anyway the record is dropped (and
+/// counted). The header of the file is written with the first record, once
+/// the controllers of the driver station are known.
+///
+/// The clock of the roboRIO is not set when the program starts, so the logs
+/// are numbered instead of dated: each log takes the number after the
+/// highest one in the directory, and the oldest logs are deleted so that
+/// only the last Telemetry::kKeepLogs remain.
+///
+/// If the file cannot be written (the disk is full), the recorder stops and
+/// failed() returns true.
+///
+class TelemetryRecorder {
+  public:
+    explicit TelemetryRecorder();
+    ~TelemetryRecorder();
+
+    bool start();
+
+    TelemetryRecord* claim (const char* const (&controllers)[TelemetryRecord::kJoysticks]);
+    void publish();
+
+    bool failed() const;
+    uint32_t written() const;
+    uint32_t dropped() const;
+
+  private:
+    void run();
+    bool drain();
+
+    SpscRing<TelemetryRecord, Telemetry::kRingSize> m_ring;
+
+    FILE* m_file;
+    std::string m_path;
+    const char* m_controllers[TelemetryRecord::kJoysticks];
+    bool m_named;
+    bool m_headerWritten;
+    uint32_t m_loop;
+    std::atomic<bool> m_failed;
+    std::atomic<uint32_t> m_written;
+    std::atomic<uint32_t> m_dropped;
+
+    std::atomic<bool> m_stop;
+    std::thread m_thread;
+};
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "telemetry_log.h"
+
+#include <string.h>
+
+static const char kMagic[8] = { 'K', 'Z', 'T', 'E', 'L', 'E', 'M', 'T' };
+static const uint32_t kVersion = 3;
+static const int kNameSize = 32;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    char controllers[TelemetryRecord::kJoysticks][kNameSize];
+};
+
+//===============================================================================
+// TelemetryLog::writeHeader
+//===============================================================================
+
+bool TelemetryLog::writeHeader (FILE* file,
+                                const char* const (&controllers)[TelemetryRecord::kJoysticks]) {
+    Header header;
+    memset (&header, 0, sizeof (header));
+    memcpy (header.magic, kMagic, sizeof (kMagic));
+    header.version = kVersion;
+    header.recordSize = sizeof (TelemetryRecord);
+
+    for (int i = 0; i < TelemetryRecord::kJoysticks; ++i)
+        strncpy (header.controllers[i], controllers[i], kNameSize - 1);
+
+    return fwrite (&header, sizeof (header), 1, file) == 1;
+}
+
+//===============================================================================
+// TelemetryLog::read
+//===============================================================================
+
+///
+/// Reads all the records of a log, and the controller of each joystick if
+/// \a controllers is given. Returns false if the file cannot be read or was
+/// written by an incompatible version of the program. A truncated last
+/// record (if the robot lost power) is ignored.
+///
+bool TelemetryLog::read (const std::string& path, std::vector<TelemetryRecord>& records,
+                         std::vector<std::string>* controllers) {
+    records.clear();
+
+    FILE* file = fopen (path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    Header header;
+    bool valid = fread (&header, sizeof (header), 1, file) == 1 &&
+                 memcmp (header.magic, kMagic, sizeof (kMagic)) == 0 &&
+                 header.version == kVersion &&
+                 header.recordSize == sizeof (TelemetryRecord);
+
+    if (valid && controllers) {
+        controllers->clear();
+        for (int i = 0; i < TelemetryRecord::kJoysticks; ++i) {
+            header.controllers[i][kNameSize - 1] = 0;
+            controllers->push_back (header.controllers[i]);
+        }
+    }
+
+    TelemetryRecord record;
+    while (valid && fread (&record, sizeof (record), 1, file) == 1)
+        records.push_back (record);
+
+    fclose (file);
+    return valid;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+///
+/// Inputs and outputs of one loop of the robot program.
+///
+/// This file does not depend on WPILib, so that the logs can also be read by
+/// the tools and by the simulation.
+///
+struct TelemetryRecord {
+    enum Mode {
+        kDisabled,
+        kAutonomous,
+        kTeleop,
+    };
+
+    static const int kJoysticks = 2;
+    static const int kAxes = 6;
+
+    ///
+    /// The channels of OutputFrame (the shooter wheels are in RPM), followed
+    /// by the hands and the shooter actuator (which are PWM motors)
+    ///
+    static const int kMotors = 11;
+
+    double time;
+    uint32_t loop;
+    uint8_t mode;
+    uint8_t solenoid;
+    uint8_t compressor;
+    uint8_t reserved;
+
+    float timer;
+    float range;
+
+    /* Pose of the robot (see Odometry), in inches and degrees */
+    float x;
+    float y;
+    float heading;
+
+    uint32_t buttons[kJoysticks];
+    float axes[kJoysticks][kAxes];
+    float motors[kMotors];
+};
+
+///
+/// Binary telemetry file: a small header followed by the records, exactly
+/// as they are stored in memory. The header names the controller profile of
+/// each joystick (see ControllerProfile), so that a replay reads the axes
+/// of the driver station the same way.
+///
+namespace TelemetryLog {
+bool writeHeader (FILE* file,
+                  const char* const (&controllers)[TelemetryRecord::kJoysticks]);
+bool read (const std::string& path, std::vector<TelemetryRecord>& records,
+           std::vector<std::string>* controllers = nullptr);
+}
@@ -35,8 +35,10 @@ int main() {
     HALReport (HALUsageReporting::kResourceType_Language,
                HALUsageReporting::kLanguage_CPlusPlus);
 
-    Robot* robot = new Robot();
-    RobotBase::robotSetup (robot);
+    /* The robot is constructed once the HAL is ready, and is never moved */
+    static Robot robot;
+    RobotBase::robotSetup (&robot);
+    robot.stop();
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "auto_aim.h"
+
+#include <algorithm>
+
+//===============================================================================
+// AutoAim::AutoAim
+//===============================================================================
+
+AutoAim::AutoAim (Vision* vision, Powertrain* powertrain, Odometry* odometry) :
+    m_vision (vision),
+    m_powertrain (powertrain),
+    m_odometry (odometry),
+    m_samples (0),
+    m_next (0),
+    m_aligned (false) {
+    reset();
+}
+
+//===============================================================================
+// AutoAim::reset
+//===============================================================================
+
+///
+/// Forgets the setpoint, called when the driver presses the auto-aim button.
+/// The heading history is kept, the frames that arrive just after the press
+/// were captured before it.
+///
+void AutoAim::reset() {
+    m_frame = 0;
+    m_setpoint = 0;
+    m_hasSetpoint = false;
+}
+
+//===============================================================================
+// AutoAim::track
+//===============================================================================
+
+///
+/// Adds the heading of the current cycle to the history, must be called on
+/// every cycle (whether the robot is aiming or not) after the odometry is
+/// updated
+///
+void AutoAim::track() {
+    const Pose& pose = m_odometry->pose();
+    remember (pose.timestamp, pose.heading);
+}
+
+//===============================================================================
+// AutoAim::aim
+//===============================================================================
+
+///
+/// Updates the setpoint when the vision pipeline has processed a new frame,
+/// and drives the robot towards it. The forward axis is scaled like the
+/// drive axes of Powertrain.
+///
+void AutoAim::aim (const JoystickState& joystick) {
+    const Pose& pose = m_odometry->pose();
+    const double now = pose.timestamp;
+    const double heading = pose.heading;
+
+    VisionTarget target;
+    if (m_vision->target (target) && (!m_hasSetpoint || target.frame != m_frame) &&
+        now - target.timestamp <= Aim::kMaxLatency) {
+        m_frame = target.frame;
+        m_setpoint = headingAt (target.timestamp) - target.bearing;
+        m_hasSetpoint = true;
+    }
+
+    m_powertrain->drive (rotation (heading, pose.turnRate),
+                         joystick.shaped (OI::kY_DriveAxis) * -0.92, 0,
+                         joystick.button (OI::kY_InvertButton));
+
+    m_aligned = m_hasSetpoint && fabs (heading - m_setpoint) <= Aim::kTolerance;
+}
+
+//===============================================================================
+// AutoAim::aligned
+//===============================================================================
+
+bool AutoAim::aligned() const {
+    return m_aligned;
+}
+
+//===============================================================================
+// AutoAim::remember
+//===============================================================================
+
+void AutoAim::remember (double timestamp, double heading) {
+    m_history[m_next].timestamp = timestamp;
+    m_history[m_next].heading = heading;
+    m_next = (m_next + 1) % kHistory;
+
+    if (m_samples < kHistory)
+        ++m_samples;
+}
+
+//===============================================================================
+// AutoAim::sample
+//===============================================================================
+
+///
+/// Returns a sample of the history, 0 being the newest one
+///
+const AutoAim::HeadingSample& AutoAim::sample (int age) const {
+    return m_history[(m_next - 1 - age + kHistory) % kHistory];
+}
+
+//===============================================================================
+// AutoAim::headingAt
+//===============================================================================
+
+///
+/// Interpolates the heading of the robot at the given time, the oldest (or
+/// newest) heading is used if the time is outside of the history
+///
+double AutoAim::headingAt (double timestamp) const {
+    for (int age = 0; age < m_samples; ++age) {
+        const HeadingSample& older = sample (age);
+        if (older.timestamp > timestamp)
+            continue;
+
+        if (age == 0)
+            return older.heading;
+
+        const HeadingSample& newer = sample (age - 1);
+        const double t = (timestamp - older.timestamp) / (newer.timestamp - older.timestamp);
+        return older.heading + (newer.heading - older.heading) * t;
+    }
+
+    return m_samples > 0 ? sample (m_samples - 1).heading : 0;
+}
+
+//===============================================================================
+// AutoAim::rotation
+//===============================================================================
+
+///
+/// PD controller on the heading error (positive when the target is to the
+/// right). The output is raised to the minimum that still turns the robot,
+/// and the robot stops once it is within the tolerance.
+///
+float AutoAim::rotation (double heading, double rate) const {
+    const double error = heading - m_setpoint;
+    if (!m_hasSetpoint || fabs (error) <= Aim::kTolerance)
+        return 0;
+
+    const double output = Aim::kP * error + Aim::kD * rate;
+    const double magnitude = std::min (std::max (fabs (output), Aim::kMinOutput),
+                                       Aim::kMaxOutput);
+    return (float) copysign (magnitude, output);
+}
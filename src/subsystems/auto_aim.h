@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "core/common.h"
+#include "core/inputs.h"
+#include "subsystems/vision.h"
+#include "subsystems/odometry.h"
+#include "subsystems/powertrain.h"
+
+///
+/// Turns the robot towards the vision target while the driver holds the
+/// auto-aim button, the driver keeps the forward/backward control.
+///
+/// A frame shows the target where it was when the frame was captured, and
+/// the robot kept turning while the frame was processed. The heading of
+/// every cycle is kept in a short history, so each new frame gives a fixed
+/// setpoint: the heading of the robot when the frame was captured, minus
+/// the bearing of the target in that frame. Between frames, the loop closes
+/// on the heading and turn rate of the odometry, which must be updated
+/// before track() and aim() are called. The history is recorded by track()
+/// on every cycle, so it already covers the latency of the first frames
+/// when the button is pressed.
+///
+class AutoAim {
+  public:
+    explicit AutoAim (Vision* vision, Powertrain* powertrain, Odometry* odometry);
+
+    void reset();
+    void track();
+    void aim (const JoystickState& joystick);
+    bool aligned() const;
+
+  private:
+    struct HeadingSample {
+        double timestamp;
+        double heading;
+    };
+
+    static const int kHistory = 64;
+
+    void remember (double timestamp, double heading);
+    double headingAt (double timestamp) const;
+    const HeadingSample& sample (int age) const;
+    float rotation (double heading, double rate) const;
+
+    Vision* m_vision;
+    Powertrain* m_powertrain;
+    Odometry* m_odometry;
+
+    HeadingSample m_history[kHistory];
+    int m_samples;
+    int m_next;
+
+    uint32_t m_frame;
+    double m_setpoint;
+    bool m_hasSetpoint;
+    bool m_aligned;
+};
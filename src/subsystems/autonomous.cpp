@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "autonomous.h"
+
+//===============================================================================
+// Autonomous::Autonomous
+//===============================================================================
+
+Autonomous::Autonomous (Powertrain* powertrain) :
+    m_powertrain (powertrain),
+    m_notifier (&Autonomous::follow, this),
+    m_profile (nullptr),
+    m_startTime (0),
+    m_running (false),
+    m_idle (false),
+    m_finished (false),
+    m_maxError (0) {
+    for (int i = 0; i < MotionProfile::kSides; ++i)
+        m_start[i] = m_lastError[i] = 0;
+}
+
+//===============================================================================
+// Autonomous::~Autonomous
+//===============================================================================
+
+Autonomous::~Autonomous() {
+    stop();
+}
+
+//===============================================================================
+// Autonomous::start
+//===============================================================================
+
+///
+/// Takes the drive motors and starts following the given profile from the
+/// current position of the robot
+///
+void Autonomous::start (const MotionProfile* profile) {
+    stop();
+
+    m_profile = profile;
+    m_start[MotionProfile::kLeft] = m_powertrain->leftDistance();
+    m_start[MotionProfile::kRight] = m_powertrain->rightDistance();
+    m_lastError[MotionProfile::kLeft] = m_lastError[MotionProfile::kRight] = 0;
+    m_startTime = Timer::GetFPGATimestamp();
+    m_finished = false;
+    m_maxError = 0;
+    m_running = true;
+    m_idle = false;
+
+    m_powertrain->setDirectOutput (true);
+    m_notifier.StartPeriodic (Profiles::kPeriod);
+}
+
+//===============================================================================
+// Autonomous::stop
+//===============================================================================
+
+///
+/// Stops the follower and gives the drive motors back to the output frame
+///
+void Autonomous::stop() {
+    if (!m_running)
+        return;
+
+    m_notifier.Stop();
+    m_powertrain->follow (0, 0);
+    m_powertrain->setDirectOutput (false);
+    m_running = false;
+}
+
+//===============================================================================
+// Autonomous::finished
+//===============================================================================
+
+///
+/// Returns true once the end of the current profile has been reached
+///
+bool Autonomous::finished() const {
+    return m_finished;
+}
+
+//===============================================================================
+// Autonomous::maxError
+//===============================================================================
+
+///
+/// Returns the largest position error (in inches) of the current or last
+/// profile
+///
+double Autonomous::maxError() const {
+    return m_maxError;
+}
+
+//===============================================================================
+// Autonomous::follow
+//===============================================================================
+
+///
+/// Called by the notifier, writes the output of the current sample of the
+/// profile
+///
+void Autonomous::follow() {
+    const MotionProfile& profile = *m_profile;
+    const double elapsed = Timer::GetFPGATimestamp() - m_startTime;
+
+    int point = (int) (elapsed / profile.period + 0.5);
+    if (point >= profile.count - 1) {
+        point = profile.count - 1;
+        m_finished = true;
+    }
+
+    const double measured[MotionProfile::kSides] = {
+        m_powertrain->leftDistance() - m_start[MotionProfile::kLeft],
+        m_powertrain->rightDistance() - m_start[MotionProfile::kRight]
+    };
+
+    float output[MotionProfile::kSides];
+    double maxError = m_maxError;
+    bool settled = m_finished;
+
+    for (int side = 0; side < MotionProfile::kSides; ++side) {
+        const double error = profile.position[side][point] - measured[side];
+        const double rate = (error - m_lastError[side]) / Profiles::kPeriod;
+        m_lastError[side] = error;
+        maxError = fmax (maxError, fabs (error));
+        settled = settled && fabs (error) <= Profiles::kTolerance;
+
+        output[side] = (float) (Profiles::kV * profile.velocity[side][point] +
+                                Profiles::kA * profile.acceleration[side][point] +
+                                Profiles::kP * error + Profiles::kD * rate);
+    }
+
+    m_maxError = maxError;
+
+    /* Stop sending frames once the robot rests at the end of the profile */
+    if (settled) {
+        if (!m_idle)
+            m_powertrain->follow (0, 0);
+
+        m_idle = true;
+        return;
+    }
+
+    m_idle = false;
+    m_powertrain->follow (output[MotionProfile::kLeft], output[MotionProfile::kRight]);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include "core/common.h"
+#include "subsystems/powertrain.h"
+#include "subsystems/motion_profile.h"
+
+///
+/// Drives the robot along motion profiles during the autonomous period.
+///
+/// The profiles are generated when the robot program starts (see
+/// Sequencer). While a profile runs, a notifier calls follow() every
+/// Profiles::kPeriod seconds, which looks up the sample of the current time
+/// and writes the drive motors directly (they are detached from the output
+/// frame): the output of each side is the feed-forward of the profile plus
+/// a correction from the position measured by the encoders. Once the
+/// profile ends, the robot holds its final position (without writing the
+/// motors while it is there).
+///
+/// start() and stop() must be called from the control loop, which runs on
+/// the same notifier thread as follow().
+///
+class Autonomous {
+  public:
+    explicit Autonomous (Powertrain* powertrain);
+    ~Autonomous();
+
+    void start (const MotionProfile* profile);
+    void stop();
+
+    bool finished() const;
+    double maxError() const;
+
+  private:
+    void follow();
+
+    Powertrain* m_powertrain;
+    Notifier m_notifier;
+
+    const MotionProfile* m_profile;
+    double m_startTime;
+    double m_start[MotionProfile::kSides];
+    double m_lastError[MotionProfile::kSides];
+    bool m_running;
+    bool m_idle;
+
+    std::atomic<bool> m_finished;
+    std::atomic<double> m_maxError;
+};
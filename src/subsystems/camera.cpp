@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "camera.h"
+
+//===============================================================================
+// Camera::Camera
+//===============================================================================
+
+Camera::Camera (const char* name) : m_camera (name, true) {
+    m_camera.SetSize (Cameras::kWidth, Cameras::kHeight);
+    m_camera.SetFPS (Cameras::kFPS);
+    m_camera.OpenCamera();
+    m_camera.StartCapture();
+
+    m_image = imaqCreateImage (IMAQ_IMAGE_RGB, 0);
+}
+
+//===============================================================================
+// Camera::~Camera
+//===============================================================================
+
+Camera::~Camera() {
+    m_camera.StopCapture();
+    imaqDispose (m_image);
+}
+
+//===============================================================================
+// Camera::width
+//===============================================================================
+
+int Camera::width() const {
+    return Cameras::kWidth;
+}
+
+//===============================================================================
+// Camera::height
+//===============================================================================
+
+int Camera::height() const {
+    return Cameras::kHeight;
+}
+
+//===============================================================================
+// Camera::grab
+//===============================================================================
+
+///
+/// A USB camera has no end, an empty or unexpected image (the camera is being
+/// reconnected, or has not started yet) is retried
+///
+FrameSource::Status Camera::grab (Frame& frame, double& timestamp) {
+    m_camera.GetImage (m_image);
+    timestamp = Timer::GetFPGATimestamp() - Cameras::kLatency;
+    CameraServer::GetInstance()->SetImage (m_image);
+
+    ImageInfo info;
+    if (!imaqGetImageInfo (m_image, &info) || !info.imageStart)
+        return kRetry;
+
+    if (info.xRes != frame.width || info.yRes != frame.height)
+        return kRetry;
+
+    /* NI images use 32-bit BGRA pixels, with padding at the end of rows */
+    for (int y = 0; y < frame.height; ++y) {
+        const RGBValue* src = (const RGBValue*) info.imageStart + y * info.pixelsPerLine;
+        uint8_t* dst = frame.row (y);
+
+        for (int x = 0; x < frame.width; ++x) {
+            dst[x * 3 + 0] = src[x].B;
+            dst[x * 3 + 1] = src[x].G;
+            dst[x * 3 + 2] = src[x].R;
+        }
+    }
+
+    return kGrabbed;
+}
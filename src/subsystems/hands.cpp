@@ -26,9 +26,8 @@
 // Hands::Hands
 //===============================================================================
 
-Hands::Hands() {
-    m_motor = new Talon (Motors::kHandsActuator);
-    m_motor->SetInverted (true);
+Hands::Hands() : m_motor (Motors::kHandsActuator) {
+    m_motor.SetInverted (true);
 }
 
 //===============================================================================
@@ -36,20 +35,20 @@ Hands::Hands() {
 //===============================================================================
 
 void Hands::move (float value) {
-    m_motor->Set (ADJUST_INPUT (value, 0));
+    m_motor.Set (value);
 }
 
 //===============================================================================
 // Hands::move
 //===============================================================================
 
-void Hands::move (const Joystick& joystick) {
+void Hands::move (const JoystickState& joystick) {
     float value = 0;
 
-    if (joystick.GetRawButton (OI::kLiftHand))
+    if (joystick.button (OI::kLiftHand))
         value = 1.0;
 
-    else if (joystick.GetRawButton (OI::kDropHand))
+    else if (joystick.button (OI::kDropHand))
         value = -0.5;
 
     move (value);
@@ -60,5 +59,13 @@ void Hands::move (const Joystick& joystick) {
 //===============================================================================
 
 void Hands::setSafetyEnabled (bool enabled) {
-    m_motor->SetSafetyEnabled (enabled);
+    m_motor.SetSafetyEnabled (enabled);
+}
+
+//===============================================================================
+// Hands::output
+//===============================================================================
+
+float Hands::output() const {
+    return m_motor.Get();
 }
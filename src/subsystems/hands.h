@@ -23,15 +23,18 @@
 #pragma once
 
 #include "core/common.h"
+#include "core/inputs.h"
 
 class Hands {
   public:
     explicit Hands();
 
     void move (float value);
-    void move (const Joystick& joystick);
+    void move (const JoystickState& joystick);
     void setSafetyEnabled (bool enabled);
 
+    float output() const;
+
   private:
-    Talon* m_motor;
+    Talon m_motor;
 };
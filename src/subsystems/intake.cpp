@@ -26,8 +26,10 @@
 // Intake::Intake
 //===============================================================================
 
-Intake::Intake() {
-    m_motor = new WinT_Motor (Motors::kIntakeMotor);
+Intake::Intake (OutputFrame* outputs) :
+    m_outputs (outputs),
+    m_motor (Motors::kIntakeMotor) {
+    m_outputs->attach (OutputFrame::kIntake, &m_motor);
 }
 
 //===============================================================================
@@ -35,25 +37,29 @@ Intake::Intake() {
 //===============================================================================
 
 void Intake::move (float intake) {
-    m_motor->Set (ADJUST_INPUT (intake, 0));
+    m_outputs->set (OutputFrame::kIntake, intake);
 }
 
 //===============================================================================
 // Intake::move
 //===============================================================================
 
-void Intake::move (const Joystick& joystick) {
-    float left = joystick.GetRawAxis (OI::kIntakeTake);
-    float right = joystick.GetRawAxis (OI::kIntakeGive);
+///
+/// Runs the intake with the trigger that is pressed the most, its shaped
+/// value is already in the snapshot
+///
+void Intake::move (const JoystickState& joystick) {
+    float left = joystick.axis (OI::kIntakeTake);
+    float right = joystick.axis (OI::kIntakeGive);
+    float output = 0;
 
     if (left > right)
-        move (left);
+        output = joystick.shaped (OI::kIntakeTake);
 
     else if (right > left)
-        move (right * -1);
+        output = joystick.shaped (OI::kIntakeGive) * -1;
 
-    else
-        move (0);
+    m_outputs->set (OutputFrame::kIntake, output);
 }
 
 //===============================================================================
@@ -61,5 +67,16 @@ void Intake::move (const Joystick& joystick) {
 //===============================================================================
 
 void Intake::setSafetyEnabled (bool enabled) {
-    m_motor->SetSafetyEnabled (enabled);
+    m_motor.SetSafetyEnabled (enabled);
+}
+
+//===============================================================================
+// Intake::current
+//===============================================================================
+
+///
+/// Returns the current drawn by the intake motor (in amps)
+///
+float Intake::current() const {
+    return m_motor.GetOutputCurrent();
 }
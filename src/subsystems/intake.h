@@ -23,16 +23,20 @@
 #pragma once
 
 #include "core/common.h"
+#include "core/inputs.h"
+#include "core/output_frame.h"
 
 class Intake {
   public:
-    explicit Intake();
+    explicit Intake (OutputFrame* outputs);
     void move (float value);
-    void move (const Joystick& joystick);
+    void move (const JoystickState& joystick);
     void setSafetyEnabled (bool enabled);
+    float current() const;
 
   private:
-    WinT_Motor* m_motor;
+    OutputFrame* m_outputs;
+    WinT_Motor m_motor;
 };
 
 
@@ -26,37 +26,35 @@
 // Lifter::Lifter
 //===============================================================================
 
-Lifter::Lifter() {
-    m_compressor = new Compressor     (Pneumatics::kCompressor);
-    m_solenoid   = new DoubleSolenoid (Pneumatics::kLifterPiston_Up,
-                                       Pneumatics::kLifterPiston_Down);
-
-    m_compressor->SetClosedLoopControl (false);
-}
-
-//===============================================================================
-// Lifter::enableCompressor
-//===============================================================================
-
-void Lifter::enableCompressor (bool enabled) {
-    enabled ? m_compressor->Start() : m_compressor->Stop();
+Lifter::Lifter() :
+    m_compressor (Pneumatics::kCompressor),
+    m_solenoid (Pneumatics::kLifterPiston_Up, Pneumatics::kLifterPiston_Down),
+    m_value (DoubleSolenoid::kOff),
+    m_state (kCompressorOff),
+    m_closedLoop (false),
+    m_automatic (true),
+    m_lastPeak (0) {
+    m_compressor.Stop();
+    m_solenoid.Set (m_value);
 }
 
 //===============================================================================
 // Lifter::move
 //===============================================================================
 
-void Lifter::move (const Joystick& joystick) {
+void Lifter::move (const JoystickState& joystick) {
     DoubleSolenoid::Value solenoidDirection = DoubleSolenoid::kOff;
 
-    if (joystick.GetRawButton (OI::kLifterUp))
+    if (joystick.button (OI::kLifterUp))
         solenoidDirection = DoubleSolenoid::kForward;
 
-    else if (joystick.GetRawButton (OI::kLifterDown))
+    else if (joystick.button (OI::kLifterDown))
         solenoidDirection = DoubleSolenoid::kReverse;
 
     move (solenoidDirection);
-    enableCompressor (joystick.GetRawButton (OI::kEnableCompressor));
+
+    if (joystick.pressed (OI::kToggleCompressorAuto))
+        m_automatic = !m_automatic;
 }
 
 //===============================================================================
@@ -64,5 +62,85 @@ void Lifter::move (const Joystick& joystick) {
 //===============================================================================
 
 void Lifter::move (DoubleSolenoid::Value value) {
-    m_solenoid->Set (value);
+    if (value != m_value) {
+        m_value = value;
+        m_solenoid.Set (value);
+    }
+}
+
+//===============================================================================
+// Lifter::update
+//===============================================================================
+
+///
+/// Runs the compressor state machine, must be called on every cycle with the
+/// current drawn by the motors of the drivetrain and the shooter (in amps).
+/// The compressor is shed as soon as the load goes over kShedCurrent, and
+/// comes back once the load has stayed under kResumeCurrent for a while.
+///
+void Lifter::update (float load) {
+    const double now = Timer::GetFPGATimestamp();
+    if (load > Pneumatics::kResumeCurrent)
+        m_lastPeak = now;
+
+    const bool peak = load > Pneumatics::kShedCurrent ||
+                      (m_state == kCompressorShed && now - m_lastPeak < Pneumatics::kResumeDelay);
+
+    CompressorState state = kCompressorCharging;
+    if (!m_automatic)
+        state = kCompressorOff;
+
+    else if (!m_compressor.GetPressureSwitchValue())
+        state = kCompressorFull;
+
+    else if (peak)
+        state = kCompressorShed;
+
+    /* The PCM stops the compressor by itself once the tanks are full */
+    const bool closedLoop = state == kCompressorFull || state == kCompressorCharging;
+    if (closedLoop != m_closedLoop) {
+        m_closedLoop = closedLoop;
+        closedLoop ? m_compressor.Start() : m_compressor.Stop();
+    }
+
+    m_state = state;
+}
+
+//===============================================================================
+// Lifter::compressorEnabled
+//===============================================================================
+
+///
+/// Returns true while the compressor is running
+///
+bool Lifter::compressorEnabled() const {
+    return m_compressor.Enabled();
+}
+
+//===============================================================================
+// Lifter::compressorAutomatic
+//===============================================================================
+
+///
+/// Returns true while the compressor is under automatic control, false once
+/// the operator turned it off
+///
+bool Lifter::compressorAutomatic() const {
+    return m_automatic;
+}
+
+//===============================================================================
+// Lifter::compressorState
+//===============================================================================
+
+Lifter::CompressorState Lifter::compressorState() const {
+    return m_state;
+}
+
+//===============================================================================
+// Lifter::solenoid
+//===============================================================================
+
+DoubleSolenoid::Value Lifter::solenoid() const {
+    return m_value;
 }
@@ -23,16 +23,46 @@
 #pragma once
 
 #include "core/common.h"
+#include "core/inputs.h"
 
+///
+/// Moves the lifter pistons and runs the compressor.
+///
+/// The solenoid and the compressor are only commanded when their state
+/// changes. The compressor is under the closed-loop control of the PCM,
+/// which runs it while the pressure switch reports a low pressure, but it is
+/// stopped while the drivetrain and the shooter draw peak currents (see
+/// Pneumatics) so that it does not pull the battery voltage down further.
+/// The operator toggles the automatic control off and on again by pressing
+/// kToggleCompressorAuto.
+///
 class Lifter {
   public:
+    enum CompressorState {
+        kCompressorOff,
+        kCompressorFull,
+        kCompressorCharging,
+        kCompressorShed,
+    };
+
     explicit Lifter();
 
-    void enableCompressor (bool enabled);
-    void move (const Joystick& joystick);
+    void move (const JoystickState& joystick);
     void move (DoubleSolenoid::Value value);
+    void update (float load);
+
+    bool compressorEnabled() const;
+    bool compressorAutomatic() const;
+    CompressorState compressorState() const;
+    DoubleSolenoid::Value solenoid() const;
 
   private:
-    Compressor* m_compressor;
-    DoubleSolenoid* m_solenoid;
+    Compressor m_compressor;
+    DoubleSolenoid m_solenoid;
+
+    DoubleSolenoid::Value m_value;
+    CompressorState m_state;
+    bool m_closedLoop;
+    bool m_automatic;
+    double m_lastPeak;
 };
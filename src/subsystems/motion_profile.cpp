@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "motion_profile.h"
+
+#include <math.h>
+
+//===============================================================================
+// MotionProfile::MotionProfile
+//===============================================================================
+
+MotionProfile::MotionProfile() : count (0), period (0) {}
+
+//===============================================================================
+// MotionProfile::duration
+//===============================================================================
+
+double MotionProfile::duration() const {
+    return count > 0 ? (count - 1) * period : 0;
+}
+
+//===============================================================================
+// MotionProfile::trapezoid
+//===============================================================================
+
+///
+/// Generates a trapezoidal velocity profile: the side with the longest
+/// distance accelerates to \a maxVelocity, cruises and decelerates, the
+/// other side follows the same profile scaled to its own distance (so a
+/// straight line has equal distances, and a turn in place has opposite
+/// ones). The profile becomes triangular when the distance is too short to
+/// reach the maximum velocity.
+///
+/// Returns false if the profile does not fit in kMaxPoints samples.
+///
+bool MotionProfile::trapezoid (double left, double right, double maxVelocity,
+                               double maxAcceleration, double period) {
+    const double distance = fmax (fabs (left), fabs (right));
+    const double scale[kSides] = {
+        distance > 0 ? left / distance : 0,
+        distance > 0 ? right / distance : 0
+    };
+
+    double accelTime = maxVelocity / maxAcceleration;
+    double peak = maxVelocity;
+    if (peak * accelTime > distance) {
+        accelTime = sqrt (distance / maxAcceleration);
+        peak = maxAcceleration * accelTime;
+    }
+
+    const double cruiseTime = peak > 0 ? (distance - peak * accelTime) / peak : 0;
+    const double total = 2 * accelTime + cruiseTime;
+    const int points = (int) ceil (total / period) + 1;
+    if (points > kMaxPoints)
+        return false;
+
+    count = points;
+    this->period = period;
+
+    for (int i = 0; i < points; ++i) {
+        const double t = fmin (i * period, total);
+        double s, v, a;
+
+        if (t < accelTime) {
+            a = maxAcceleration;
+            v = a * t;
+            s = a * t * t / 2;
+        }
+
+        else if (t < accelTime + cruiseTime) {
+            a = 0;
+            v = peak;
+            s = peak * (accelTime / 2 + t - accelTime);
+        }
+
+        else {
+            const double remaining = total - t;
+            a = remaining > 0 ? -maxAcceleration : 0;
+            v = maxAcceleration * remaining;
+            s = distance - maxAcceleration * remaining * remaining / 2;
+        }
+
+        for (int side = 0; side < kSides; ++side) {
+            position[side][i] = (float) (s * scale[side]);
+            velocity[side][i] = (float) (v * scale[side]);
+            acceleration[side][i] = (float) (a * scale[side]);
+        }
+    }
+
+    return true;
+}
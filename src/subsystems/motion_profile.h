@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+///
+/// Precomputed path of the two sides of the drivetrain, sampled every
+/// \c period seconds. The samples are stored in flat arrays (one for each
+/// quantity and side) so that following a profile is a lookup by index.
+///
+/// Profiles are generated when the robot program starts, never during a
+/// match, and the follower does not allocate anything.
+///
+struct MotionProfile {
+    enum Side {
+        kLeft,
+        kRight,
+        kSides,
+    };
+
+    static const int kMaxPoints = 1024;
+
+    int count;
+    double period;
+
+    float position[kSides][kMaxPoints];
+    float velocity[kSides][kMaxPoints];
+    float acceleration[kSides][kMaxPoints];
+
+    explicit MotionProfile();
+
+    double duration() const;
+    bool trapezoid (double left, double right, double maxVelocity, double maxAcceleration,
+                    double period);
+};
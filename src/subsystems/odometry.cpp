@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "odometry.h"
+
+//===============================================================================
+// Odometry::Odometry
+//===============================================================================
+
+Odometry::Odometry (Powertrain* powertrain) : m_powertrain (powertrain) {
+    reset();
+}
+
+//===============================================================================
+// Odometry::reset
+//===============================================================================
+
+///
+/// Makes the current position of the robot the origin, facing along x
+///
+void Odometry::reset() {
+    m_left = m_powertrain->leftDistance();
+    m_right = m_powertrain->rightDistance();
+    m_x = 0;
+    m_y = 0;
+    m_heading = 0;
+
+    m_pose.timestamp = Timer::GetFPGATimestamp();
+    m_pose.x = 0;
+    m_pose.y = 0;
+    m_pose.heading = 0;
+    m_pose.velocity = 0;
+    m_pose.turnRate = 0;
+    m_published.store (m_pose);
+}
+
+//===============================================================================
+// Odometry::update
+//===============================================================================
+
+///
+/// Moves the pose by the travel of the wheels since the previous update. The
+/// robot is assumed to move along an arc, so the distance is projected on
+/// the heading halfway through the update.
+///
+void Odometry::update() {
+    const double left = m_powertrain->leftDistance();
+    const double right = m_powertrain->rightDistance();
+    const double leftDelta = left - m_left;
+    const double rightDelta = right - m_right;
+    m_left = left;
+    m_right = right;
+
+    const double distance = (leftDelta + rightDelta) / 2;
+    const double turn = (rightDelta - leftDelta) / Drive::kTrackWidth;
+    const double middle = m_heading + turn / 2;
+    m_x += distance * cos (middle);
+    m_y += distance * sin (middle);
+    m_heading += turn;
+
+    const double leftSpeed = m_powertrain->leftSpeed();
+    const double rightSpeed = m_powertrain->rightSpeed();
+
+    m_pose.timestamp = Timer::GetFPGATimestamp();
+    m_pose.x = (float) m_x;
+    m_pose.y = (float) m_y;
+    m_pose.heading = (float) (m_heading * 180 / M_PI);
+    m_pose.velocity = (float) ((leftSpeed + rightSpeed) / 2);
+    m_pose.turnRate = (float) ((rightSpeed - leftSpeed) / Drive::kTrackWidth * 180 / M_PI);
+    m_published.store (m_pose);
+}
+
+//===============================================================================
+// Odometry::pose
+//===============================================================================
+
+///
+/// (Control loop) Returns the pose of the last update
+///
+const Pose& Odometry::pose() const {
+    return m_pose;
+}
+
+//===============================================================================
+// Odometry::latest
+//===============================================================================
+
+///
+/// (Any other thread, only one) Copies the pose of the last update, returns
+/// false if there is none yet
+///
+bool Odometry::latest (Pose& pose) {
+    return m_published.load (pose);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "core/common.h"
+#include "core/latest_value.h"
+#include "subsystems/powertrain.h"
+
+///
+/// Position of the robot on the field, relative to where it was when the
+/// odometry was reset. Lengths are in inches (x points forward at the reset
+/// and y to the left) and angles in degrees (counterclockwise).
+///
+struct Pose {
+    double timestamp;
+    float x;
+    float y;
+    float heading;
+    float velocity;
+    float turnRate;
+};
+
+///
+/// Tracks the pose of the robot with the drive encoders.
+///
+/// The encoders are on the motor shafts of the go-kart wheels, which are
+/// the ones that have traction: the omni wheels are driven at the same
+/// tangential speed (see KART_TO_OMNI_RATIO in the powertrain) and roll
+/// sideways, so the travel of each side is the travel of its go-kart wheel.
+/// When the robot turns, the omni wheels scrub and the go-kart wheels turn
+/// the robot less than their track width would tell, which is why the
+/// effective track width (Drive::kTrackWidth) is used for the heading.
+///
+/// update() is called by the control loop once per cycle: it reads the
+/// positions and speeds of both sides and integrates the pose along an arc.
+/// The control loop reads the pose directly, and it is published to one
+/// other thread through a lock-free slot.
+///
+class Odometry {
+  public:
+    explicit Odometry (Powertrain* powertrain);
+
+    void reset();
+    void update();
+
+    const Pose& pose() const;
+    bool latest (Pose& pose);
+
+  private:
+    Powertrain* m_powertrain;
+    LatestValue<Pose> m_published;
+
+    Pose m_pose;
+    double m_x;
+    double m_y;
+    double m_heading;
+    double m_left;
+    double m_right;
+};
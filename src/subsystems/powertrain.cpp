@@ -38,16 +38,31 @@ const float KART_TO_OMNI_RATIO = 7.9 / 10;
 // Powertrain::Powertrain
 //===============================================================================
 
-Powertrain::Powertrain() {
-    m_leftA  = new CANTalon (Motors::kLeftA);
-    m_leftB  = new CANTalon (Motors::kLeftB);
-    m_rightA = new CANTalon (Motors::kRightA);
-    m_rightB = new CANTalon (Motors::kRightB);
-
-    m_clutchA = new WinT_Motor (Motors::kClutchA);
-    m_clutchB = new WinT_Motor (Motors::kClutchB);
-    m_driveA  = new RobotDrive (m_leftA, m_rightA);
-    m_driveB  = new RobotDrive (m_leftB, m_rightB);
+///
+/// The drives write to the output frame, not to the motors
+///
+Powertrain::Powertrain (OutputFrame* outputs) :
+    m_outputs (outputs),
+    m_leftA (Motors::kLeftA),
+    m_leftB (Motors::kLeftB),
+    m_rightA (Motors::kRightA),
+    m_rightB (Motors::kRightB),
+    m_clutchA (Motors::kClutchA),
+    m_clutchB (Motors::kClutchB),
+    m_driveA (outputs->staged (OutputFrame::kLeftA), outputs->staged (OutputFrame::kRightA)),
+    m_driveB (outputs->staged (OutputFrame::kLeftB), outputs->staged (OutputFrame::kRightB)) {
+    m_outputs->attach (OutputFrame::kLeftA,   &m_leftA);
+    m_outputs->attach (OutputFrame::kLeftB,   &m_leftB);
+    m_outputs->attach (OutputFrame::kRightA,  &m_rightA);
+    m_outputs->attach (OutputFrame::kRightB,  &m_rightB);
+    m_outputs->attach (OutputFrame::kClutchA, &m_clutchA);
+    m_outputs->attach (OutputFrame::kClutchB, &m_clutchB);
+
+    /* The front Talons of each side read the drive encoders */
+    m_leftA.SetFeedbackDevice (CANTalon::QuadEncoder);
+    m_leftA.ConfigEncoderCodesPerRev (Drive::kEncoderCodes);
+    m_rightA.SetFeedbackDevice (CANTalon::QuadEncoder);
+    m_rightA.ConfigEncoderCodesPerRev (Drive::kEncoderCodes);
 }
 
 //===============================================================================
@@ -55,51 +70,159 @@ Powertrain::Powertrain() {
 //===============================================================================
 
 void Powertrain::setSafetyEnabled (bool enabled) {
-    m_driveA->SetSafetyEnabled  (enabled);
-    m_driveB->SetSafetyEnabled  (enabled);
-    m_clutchA->SetSafetyEnabled (enabled);
-    m_clutchB->SetSafetyEnabled (enabled);
+    m_driveA.SetSafetyEnabled  (enabled);
+    m_driveB.SetSafetyEnabled  (enabled);
+    m_clutchA.SetSafetyEnabled (enabled);
+    m_clutchB.SetSafetyEnabled (enabled);
 }
 
 //===============================================================================
 // Powertrain::drive
 //===============================================================================
 
+///
+/// Drives with the given outputs, which are already shaped (see
+/// JoystickState::shaped)
+///
 void Powertrain::drive (float x, float y, float sensivity, bool inverted_drive) {
     sensivity = sensivity * 0.5;
-    x = ADJUST_INPUT (x, 0) * -1;
-    y = ADJUST_INPUT (y, 0) * (inverted_drive ? 1 : -1);
+    x = x * -1;
+    y = y * (inverted_drive ? 1 : -1);
 
-    m_driveA->ArcadeDrive (y * KART_TO_OMNI_RATIO * -1, x, true);
-    m_driveB->ArcadeDrive (y * KART_TO_OMNI_RATIO * -1, x, true);
+    m_driveA.ArcadeDrive (y * KART_TO_OMNI_RATIO * -1, x, true);
+    m_driveB.ArcadeDrive (y * KART_TO_OMNI_RATIO * -1, x, true);
 
-    m_clutchA->Set (y);
-    m_clutchB->Set (y);
+    m_outputs->set (OutputFrame::kClutchA, y);
+    m_outputs->set (OutputFrame::kClutchB, y);
 }
 
 //===============================================================================
 // Powertrain::drive
 //===============================================================================
 
-void Powertrain::drive (Joystick* joystick_a, Joystick* joystick_b) {
-    float x_drive  = joystick_a->GetRawAxis (OI::kX_DriveAxis);
-    float y_drive  = joystick_a->GetRawAxis (OI::kY_DriveAxis) * -1;
-    float x_slow_b = joystick_b->GetRawAxis (OI::kX_SlowDriveAxis);
-    float y_slow_b = joystick_b->GetRawAxis (OI::kY_SlowDriveAxis) * -1;
+///
+/// Drives with the joystick that is moved the most, the axes are scaled after
+/// the deadband and the curve of the snapshot
+///
+void Powertrain::drive (const JoystickState& joystick_a, const JoystickState& joystick_b) {
+    float x_drive  = joystick_a.shaped (OI::kX_DriveAxis);
+    float y_drive  = joystick_a.shaped (OI::kY_DriveAxis) * -1;
+    float x_slow_b = joystick_b.shaped (OI::kX_SlowDriveAxis);
+    float y_slow_b = joystick_b.shaped (OI::kY_SlowDriveAxis) * -1;
 
-    bool move_with_b_joystick = (abs (x_slow_b) > abs (x_drive) ||
-                                 (abs (y_slow_b) > abs (y_drive)));
+    bool move_with_b_joystick = (fabsf (x_slow_b) > fabsf (x_drive) ||
+                                 (fabsf (y_slow_b) > fabsf (y_drive)));
 
     if (move_with_b_joystick) {
         drive (x_slow_b * 0.8,
                y_slow_b * 0.8, 1.0,
-               joystick_b->GetRawButton (OI::kY_InvertButton));
+               joystick_b.button (OI::kY_InvertButton));
     }
 
     else {
         drive (x_drive * 0.92,
                y_drive * 0.92,
-               joystick_a->GetRawButton (X360_Mappings::kButtonLeftBumper) ? 1 : 0,
-               joystick_a->GetRawButton (OI::kY_InvertButton));
+               joystick_a.button (OI::kSensitivityButton) ? 1 : 0,
+               joystick_a.button (OI::kY_InvertButton));
     }
 }
+
+//===============================================================================
+// Powertrain::setDirectOutput
+//===============================================================================
+
+///
+/// Detaches the drive motors from the output frame, so that follow() can
+/// write them from another thread (the motion profile follower), or gives
+/// them back to the frame. Must be called from the robot loop.
+///
+void Powertrain::setDirectOutput (bool direct) {
+    m_outputs->attach (OutputFrame::kLeftA,   direct ? nullptr : &m_leftA);
+    m_outputs->attach (OutputFrame::kLeftB,   direct ? nullptr : &m_leftB);
+    m_outputs->attach (OutputFrame::kRightA,  direct ? nullptr : &m_rightA);
+    m_outputs->attach (OutputFrame::kRightB,  direct ? nullptr : &m_rightB);
+    m_outputs->attach (OutputFrame::kClutchA, direct ? nullptr : &m_clutchA);
+    m_outputs->attach (OutputFrame::kClutchB, direct ? nullptr : &m_clutchB);
+}
+
+//===============================================================================
+// Powertrain::follow
+//===============================================================================
+
+///
+/// Writes the output of each side directly to the motors (positive is
+/// forward), only valid after setDirectOutput (true). The clutch motors
+/// move the omni wheel at the mean speed of both sides. The outputs are
+/// scaled like those of the frame (see PowerBudget).
+///
+void Powertrain::follow (float left, float right) {
+    const float scale = m_outputs->scale (OutputFrame::kLeftA);
+    left = fmaxf (-1, fminf (1, left)) * scale;
+    right = fmaxf (-1, fminf (1, right)) * scale;
+    const float clutch = fmaxf (-1, fminf (1, -(left + right) / 2 / KART_TO_OMNI_RATIO));
+
+    m_leftA.Set   (left);
+    m_leftB.Set   (left);
+    m_rightA.Set  (-right);
+    m_rightB.Set  (-right);
+    m_clutchA.Set (clutch);
+    m_clutchB.Set (clutch);
+}
+
+//===============================================================================
+// Powertrain::leftDistance
+//===============================================================================
+
+///
+/// Returns the distance travelled by the left wheels (in inches, positive
+/// forward) since the encoders were reset
+///
+double Powertrain::leftDistance() const {
+    return m_leftA.GetPosition() / Drive::kGearRatio * M_PI * Drive::kWheelDiameter;
+}
+
+//===============================================================================
+// Powertrain::rightDistance
+//===============================================================================
+
+///
+/// Returns the distance travelled by the right wheels, the right motors are
+/// reversed
+///
+double Powertrain::rightDistance() const {
+    return -m_rightA.GetPosition() / Drive::kGearRatio * M_PI * Drive::kWheelDiameter;
+}
+
+//===============================================================================
+// Powertrain::leftSpeed
+//===============================================================================
+
+///
+/// Returns the speed of the left wheels (in inches per second, positive
+/// forward), as measured by the Talon
+///
+double Powertrain::leftSpeed() const {
+    return m_leftA.GetSpeed() / 60 / Drive::kGearRatio * M_PI * Drive::kWheelDiameter;
+}
+
+//===============================================================================
+// Powertrain::rightSpeed
+//===============================================================================
+
+double Powertrain::rightSpeed() const {
+    return -m_rightA.GetSpeed() / 60 / Drive::kGearRatio * M_PI * Drive::kWheelDiameter;
+}
+
+//===============================================================================
+// Powertrain::current
+//===============================================================================
+
+///
+/// Returns the current drawn by the drive motors (in amps), as measured by
+/// the Talons
+///
+float Powertrain::current() const {
+    return m_leftA.GetOutputCurrent() + m_leftB.GetOutputCurrent() +
+           m_rightA.GetOutputCurrent() + m_rightB.GetOutputCurrent() +
+           m_clutchA.GetOutputCurrent() + m_clutchB.GetOutputCurrent();
+}
@@ -23,25 +23,38 @@
 #pragma once
 
 #include "core/common.h"
+#include "core/inputs.h"
+#include "core/output_frame.h"
 
 class Powertrain {
   public:
-    explicit Powertrain();
+    explicit Powertrain (OutputFrame* outputs);
     void setSafetyEnabled (bool enabled);
     void drive (float x, float y, float sensivity, bool inverted_drive);
-    void drive (Joystick* joystick_a, Joystick* joystick_b);
+    void drive (const JoystickState& joystick_a, const JoystickState& joystick_b);
+
+    void setDirectOutput (bool direct);
+    void follow (float left, float right);
+
+    double leftDistance() const;
+    double rightDistance() const;
+    double leftSpeed() const;
+    double rightSpeed() const;
+    float current() const;
 
   private:
-    RobotDrive* m_driveA;
-    RobotDrive* m_driveB;
+    OutputFrame* m_outputs;
+
+    WinT_Motor m_leftA;
+    WinT_Motor m_leftB;
+    WinT_Motor m_rightA;
+    WinT_Motor m_rightB;
 
-    WinT_Motor* m_clutchA;
-    WinT_Motor* m_clutchB;
+    WinT_Motor m_clutchA;
+    WinT_Motor m_clutchB;
 
-    WinT_Motor* m_leftA;
-    WinT_Motor* m_leftB;
-    WinT_Motor* m_rightA;
-    WinT_Motor* m_rightB;
+    RobotDrive m_driveA;
+    RobotDrive m_driveB;
 };
 
 
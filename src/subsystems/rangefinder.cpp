@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "rangefinder.h"
+
+#include <algorithm>
+
+//===============================================================================
+// Rangefinder::Rangefinder
+//===============================================================================
+
+Rangefinder::Rangefinder (uint32_t ping, uint32_t echo) :
+    m_ultrasonic (ping, echo),
+    m_notifier (&Rangefinder::measure, this),
+    m_samples (0),
+    m_average (0) {}
+
+//===============================================================================
+// Rangefinder::~Rangefinder
+//===============================================================================
+
+Rangefinder::~Rangefinder() {
+    m_notifier.Stop();
+}
+
+//===============================================================================
+// Rangefinder::start
+//===============================================================================
+
+void Rangefinder::start() {
+    m_ultrasonic.SetAutomaticMode (false);
+    m_ultrasonic.Ping();
+    m_notifier.StartPeriodic (Ranging::kPeriod);
+}
+
+//===============================================================================
+// Rangefinder::latest
+//===============================================================================
+
+///
+/// Copies the latest sample, returns false if there is none yet
+///
+bool Rangefinder::latest (RangeSample& sample) {
+    return m_latest.load (sample);
+}
+
+//===============================================================================
+// Rangefinder::fresh
+//===============================================================================
+
+///
+/// Copies the latest sample, returns false if there is none or if it is
+/// older than Ranging::kMaxAge
+///
+bool Rangefinder::fresh (RangeSample& sample) {
+    if (!latest (sample))
+        return false;
+
+    return Timer::GetFPGATimestamp() - sample.timestamp <= Ranging::kMaxAge;
+}
+
+//===============================================================================
+// Rangefinder::raw
+//===============================================================================
+
+///
+/// Returns the reading of the latest sample, without filtering, or 0 if
+/// there is none yet
+///
+float Rangefinder::raw() {
+    RangeSample sample;
+    return latest (sample) ? sample.raw : 0;
+}
+
+//===============================================================================
+// Rangefinder::measure
+//===============================================================================
+
+///
+/// Reads the echo of the previous ping (if it came back) and sends the next
+/// ping, called by the notifier
+///
+void Rangefinder::measure() {
+    if (m_ultrasonic.IsRangeValid()) {
+        RangeSample sample;
+        sample.raw = m_ultrasonic.GetRangeInches();
+        sample.inches = filter (sample.raw);
+        sample.timestamp = Timer::GetFPGATimestamp();
+        m_latest.store (sample);
+    }
+
+    m_ultrasonic.Ping();
+}
+
+//===============================================================================
+// Rangefinder::filter
+//===============================================================================
+
+///
+/// Returns the moving average of the median of the last readings
+///
+float Rangefinder::filter (float raw) {
+    m_window[m_samples % Ranging::kWindow] = raw;
+    ++m_samples;
+
+    const int count = std::min (m_samples, Ranging::kWindow);
+    float sorted[Ranging::kWindow];
+    std::copy (m_window, m_window + count, sorted);
+    std::nth_element (sorted, sorted + count / 2, sorted + count);
+
+    const float median = sorted[count / 2];
+    m_average = m_samples == 1 ? median :
+                m_average + Ranging::kSmoothing * (median - m_average);
+
+    return m_average;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "core/common.h"
+#include "core/latest_value.h"
+
+///
+/// Filtered distance measured by the rangefinder, with the reading it was
+/// filtered from
+///
+struct RangeSample {
+    float inches;
+    float raw;
+    double timestamp;
+};
+
+///
+/// Measures the distance with the ultrasonic sensor on its own schedule.
+///
+/// A notifier pings the sensor every Ranging::kPeriod seconds and reads
+/// the echo of the previous ping. The readings go through a median filter
+/// (which removes the spikes caused by missed echoes) and an exponential
+/// moving average, and the result is published in a lock-free slot.
+///
+/// The robot loop reads the latest sample in constant time and never waits
+/// for the sensor, which is only read by the notifier (a read between a ping
+/// and its echo would give an invalid range). Only the robot loop may call
+/// latest(), fresh() and raw().
+///
+class Rangefinder {
+  public:
+    explicit Rangefinder (uint32_t ping, uint32_t echo);
+    ~Rangefinder();
+
+    void start();
+
+    bool latest (RangeSample& sample);
+    bool fresh (RangeSample& sample);
+    float raw();
+
+  private:
+    void measure();
+    float filter (float raw);
+
+    Ultrasonic m_ultrasonic;
+    Notifier m_notifier;
+    LatestValue<RangeSample> m_latest;
+
+    float m_window[Ranging::kWindow];
+    int m_samples;
+    float m_average;
+};
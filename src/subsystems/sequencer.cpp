@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sequencer.h"
+
+//===============================================================================
+// Sequencer::Sequencer
+//===============================================================================
+
+Sequencer::Sequencer (Autonomous* autonomous, Shooter* shooter, Intake* intake,
+                      Lifter* lifter) :
+    m_autonomous (autonomous),
+    m_shooter (shooter),
+    m_intake (intake),
+    m_lifter (lifter),
+    m_routine (&m_routines[0]),
+    m_spare (&m_routines[1]),
+    m_groupFirst (0),
+    m_groupLast (-1),
+    m_running (false) {
+    m_routine->count = 0;
+
+    RoutineCommand crossDefense = {};
+    crossDefense.type = RoutineCommand::kDrive;
+    crossDefense.value = -Profiles::kCrossDistance;
+    load (&crossDefense, 1);
+}
+
+//===============================================================================
+// Sequencer::load
+//===============================================================================
+
+///
+/// Reads a routine file, returns false (and keeps the current routine) if
+/// it cannot be used
+///
+bool Sequencer::load (const char* path) {
+    RoutineCommand commands[RoutineFile::kMaxCommands];
+    int count = 0;
+
+    if (!RoutineFile::read (path, commands, count) || !load (commands, count)) {
+        printf ("Sequencer: cannot use %s, keeping the default routine\n", path);
+        return false;
+    }
+
+    printf ("Sequencer: loaded %d commands from %s\n", count, path);
+    return true;
+}
+
+//===============================================================================
+// Sequencer::load
+//===============================================================================
+
+///
+/// Uses the given commands as the routine and generates the profiles of the
+/// drive and turn commands. Returns false (and keeps the current routine)
+/// if the routine is not valid or needs too many profiles. The routine is
+/// built in the spare copy, which becomes the current one at the end.
+///
+bool Sequencer::load (const RoutineCommand* commands, int count) {
+    if (m_running || !RoutineFile::validate (commands, count))
+        return false;
+
+    int profiles = 0;
+    for (int i = 0; i < count; ++i) {
+        const uint8_t type = commands[i].type;
+        profiles += type == RoutineCommand::kDrive || type == RoutineCommand::kTurn;
+    }
+
+    if (profiles > Routines::kMaxProfiles)
+        return false;
+
+    Routine* routine = m_spare;
+
+    profiles = 0;
+    for (int i = 0; i < count; ++i) {
+        const RoutineCommand& command = commands[i];
+        routine->commands[i] = command;
+        routine->profileIndex[i] = -1;
+
+        double left = command.value;
+        double right = command.value;
+
+        if (command.type == RoutineCommand::kTurn) {
+            right = command.value * M_PI / 180 * Drive::kTrackWidth / 2;
+            left = -right;
+        }
+
+        else if (command.type != RoutineCommand::kDrive)
+            continue;
+
+        if (!routine->profiles[profiles].trapezoid (left, right, Profiles::kMaxVelocity,
+                                                     Profiles::kMaxAcceleration,
+                                                     Profiles::kPeriod))
+            return false;
+
+        routine->profileIndex[i] = profiles++;
+    }
+
+    routine->count = count;
+    m_spare = m_routine;
+    m_routine = routine;
+    return true;
+}
+
+//===============================================================================
+// Sequencer::start
+//===============================================================================
+
+void Sequencer::start() {
+    stop();
+    m_running = true;
+    startGroup (0);
+}
+
+//===============================================================================
+// Sequencer::run
+//===============================================================================
+
+///
+/// Updates the commands of the current group, and starts the next group once
+/// all of them have ended
+///
+void Sequencer::run() {
+    while (m_running && m_groupFirst < m_routine->count) {
+        bool done = true;
+        for (int i = m_groupFirst; i <= m_groupLast; ++i) {
+            if (!m_done[i] && update (i)) {
+                end (i);
+                m_done[i] = true;
+            }
+
+            done = done && m_done[i];
+        }
+
+        if (!done)
+            return;
+
+        startGroup (m_groupLast + 1);
+    }
+}
+
+//===============================================================================
+// Sequencer::stop
+//===============================================================================
+
+///
+/// Ends the routine and turns off everything that it was using
+///
+void Sequencer::stop() {
+    if (!m_running)
+        return;
+
+    m_running = false;
+    m_autonomous->stop();
+    m_shooter->shoot (0.0f, 0.0f);
+    m_shooter->moveBallToShooter (0);
+    m_intake->move (0);
+    m_lifter->move (DoubleSolenoid::kOff);
+}
+
+//===============================================================================
+// Sequencer::finished
+//===============================================================================
+
+bool Sequencer::finished() const {
+    return m_groupFirst >= m_routine->count;
+}
+
+//===============================================================================
+// Sequencer::startGroup
+//===============================================================================
+
+///
+/// Starts the commands that run in parallel from the given one
+///
+void Sequencer::startGroup (int first) {
+    m_groupFirst = first;
+    m_groupLast = first;
+
+    while (m_groupLast < m_routine->count - 1 &&
+           (m_routine->commands[m_groupLast].flags & RoutineCommand::kWithNext))
+        ++m_groupLast;
+
+    for (int i = m_groupFirst; i <= m_groupLast && i < m_routine->count; ++i) {
+        m_startTime[i] = Timer::GetFPGATimestamp();
+        m_done[i] = begin (i);
+    }
+}
+
+//===============================================================================
+// Sequencer::begin
+//===============================================================================
+
+///
+/// Starts a command, returns true if it has already ended
+///
+bool Sequencer::begin (int index) {
+    const RoutineCommand& command = m_routine->commands[index];
+
+    switch (command.type) {
+        case RoutineCommand::kDrive:
+        case RoutineCommand::kTurn:
+            m_autonomous->start (&m_routine->profiles[m_routine->profileIndex[index]]);
+            break;
+        case RoutineCommand::kSpinShooter:
+            if (command.value <= 0) {
+                m_shooter->shoot (0.0f, 0.0f);
+                return true;
+            }
+
+            m_shooter->shoot (command.value);
+            break;
+        case RoutineCommand::kFeed:
+            m_shooter->moveBallToShooter (command.value);
+            break;
+        case RoutineCommand::kIntake:
+            m_intake->move (command.value);
+            break;
+        case RoutineCommand::kLift:
+            m_lifter->move (command.value > 0 ? DoubleSolenoid::kForward :
+                            DoubleSolenoid::kReverse);
+            break;
+    }
+
+    return false;
+}
+
+//===============================================================================
+// Sequencer::update
+//===============================================================================
+
+///
+/// Returns true once a command has reached its goal or its timeout
+///
+bool Sequencer::update (int index) {
+    const RoutineCommand& command = m_routine->commands[index];
+    const double elapsed = Timer::GetFPGATimestamp() - m_startTime[index];
+
+    if (command.timeout > 0 && elapsed >= command.timeout)
+        return true;
+
+    switch (command.type) {
+        case RoutineCommand::kDrive:
+        case RoutineCommand::kTurn:
+            return m_autonomous->finished();
+        case RoutineCommand::kSpinShooter:
+            return m_shooter->readyToFire();
+    }
+
+    return false;
+}
+
+//===============================================================================
+// Sequencer::end
+//===============================================================================
+
+///
+/// Turns off what a timed command was running, the shooter keeps its speed
+/// and the robot holds its position until the next command that uses them
+///
+void Sequencer::end (int index) {
+    switch (m_routine->commands[index].type) {
+        case RoutineCommand::kFeed:
+            m_shooter->moveBallToShooter (0);
+            break;
+        case RoutineCommand::kIntake:
+            m_intake->move (0);
+            break;
+        case RoutineCommand::kLift:
+            m_lifter->move (DoubleSolenoid::kOff);
+            break;
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "core/common.h"
+#include "core/routine.h"
+#include "subsystems/intake.h"
+#include "subsystems/lifter.h"
+#include "subsystems/shooter.h"
+#include "subsystems/autonomous.h"
+#include "subsystems/motion_profile.h"
+
+///
+/// Runs an autonomous routine (see RoutineCommand).
+///
+/// The routine is read once when the robot program starts, into a fixed
+/// array of commands, and the motion profiles of its drive and turn
+/// commands are generated at the same time. During the match, run() is
+/// called every control cycle: it starts the commands of the current group, updates
+/// them and moves to the next group once all of them have ended. Nothing is
+/// parsed or allocated while the routine runs.
+///
+/// A routine is loaded into a spare copy (commands and profiles), which
+/// only replaces the current one once all of it is valid, so a routine that
+/// cannot be used leaves the current one as it was.
+///
+/// Until a routine is loaded, the robot crosses the defenses backwards.
+///
+class Sequencer {
+  public:
+    explicit Sequencer (Autonomous* autonomous, Shooter* shooter, Intake* intake,
+                        Lifter* lifter);
+
+    bool load (const char* path);
+    bool load (const RoutineCommand* commands, int count);
+
+    void start();
+    void run();
+    void stop();
+
+    bool finished() const;
+
+  private:
+    struct Routine {
+        RoutineCommand commands[RoutineFile::kMaxCommands];
+        int profileIndex[RoutineFile::kMaxCommands];
+        int count;
+
+        MotionProfile profiles[Routines::kMaxProfiles];
+    };
+
+    bool begin (int index);
+    bool update (int index);
+    void end (int index);
+    void startGroup (int first);
+
+    Autonomous* m_autonomous;
+    Shooter* m_shooter;
+    Intake* m_intake;
+    Lifter* m_lifter;
+
+    Routine m_routines[2];
+    Routine* m_routine;
+    Routine* m_spare;
+
+    double m_startTime[RoutineFile::kMaxCommands];
+    bool m_done[RoutineFile::kMaxCommands];
+
+    int m_groupFirst;
+    int m_groupLast;
+    bool m_running;
+};
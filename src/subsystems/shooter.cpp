@@ -22,35 +22,30 @@
 
 #include "shooter.h"
 
-///
-/// The constants used for calculating the initial velocity and
-/// motor output values based on the projectile motion concepts
-///
-/// Please note that these values are on the metric system.
-///
-const float kANGLE     = 62.00;
-const float kHEIGHT    = 2.050;
-const float kGRAVITY   = 9.807;
-const float kMAX_RANGE = 1.958;
-const float kFRICTION  = 0.470;
-
 using namespace std;
 
 //===============================================================================
 // Shooter::Shooter
 //===============================================================================
 
-Shooter::Shooter() {
-    m_actuator   = new Talon      (Motors::kShooterActuator);
-    m_motorLeft  = new WinT_Motor (Motors::kLeftShooter);
-    m_motorRight = new WinT_Motor (Motors::kRightShooter);
-    m_ultrasonic = new Ultrasonic (Sensors::kShooterRadarPing,
-                                   Sensors::kShooterRadarEcho);
-
-    m_motorLeft->SetInverted (true);
-    m_motorLeft->SetSafetyEnabled  (false);
-    m_motorRight->SetSafetyEnabled (false);
-    m_maxInitialVelocity = getInitialVelocity (kMAX_RANGE);
+Shooter::Shooter (OutputFrame* outputs) :
+    m_outputs (outputs),
+    m_actuator (Motors::kShooterActuator),
+    m_motorLeft (Motors::kLeftShooter),
+    m_motorRight (Motors::kRightShooter),
+    m_rangefinder (Sensors::kShooterRadarPing, Sensors::kShooterRadarEcho),
+    m_targetLeft (0),
+    m_targetRight (0),
+    m_peakVoltage (Power::kMaxVoltage) {
+    m_motorLeft.SetInverted (true);
+    m_motorLeft.SetSafetyEnabled  (false);
+    m_motorRight.SetSafetyEnabled (false);
+    configure (&m_motorLeft);
+    configure (&m_motorRight);
+
+    m_outputs->attach (OutputFrame::kShooterLeft,  &m_motorLeft);
+    m_outputs->attach (OutputFrame::kShooterRight, &m_motorRight);
+    m_rangefinder.start();
 }
 
 //===============================================================================
@@ -58,61 +53,182 @@ Shooter::Shooter() {
 //===============================================================================
 
 void Shooter::shoot (float inches) {
-    float output = getInitialVelocity (inches * 0.0254) / m_maxInitialVelocity;
-
-    if (output > 1)
-        output = 1;
-
-    shoot (output, output);
+    float speed = m_table.rpm (inches) * -1;
+    setSpeed (speed, speed);
 }
 
 //===============================================================================
 // Shooter::shoot
 //===============================================================================
 
+///
+/// Sets the speed of each wheel, as a fraction of the maximum speed
+///
 void Shooter::shoot (float left, float right) {
-    m_motorLeft->Set  (ADJUST_INPUT (left * -1,  0));
-    m_motorRight->Set (ADJUST_INPUT (right * -1, 0));
+    setSpeed (left * -1 * Flywheel::kMaxRPM, right * -1 * Flywheel::kMaxRPM);
 }
 
 //===============================================================================
 // Shooter::shoot
 //===============================================================================
 
-void Shooter::shoot (const Joystick& joystick) {
-    float v = joystick.GetRawButton (X360_Mappings::kButtonA) ? -1 : 1;
-    if (joystick.GetRawButton (OI::kSmartShootButton))
-        shoot (m_ultrasonic->GetRangeInches());
+void Shooter::shoot (const JoystickState& joystick) {
+    float v = joystick.button (OI::kReverseShootButton) ? -1 : 1;
+    if (joystick.button (OI::kSmartShootButton))
+        smartShoot();
 
-    if (joystick.GetRawButton (OI::kBruteShootButton))
+    else if (joystick.button (OI::kBruteShootButton))
         shoot (1 * v, 1 * v);
 
-    else {
-        shoot (joystick.GetRawAxis (OI::kShootLeftAxis) * v,
-               joystick.GetRawAxis (OI::kShootRightAxis) * v);
-    }
+    else
+        shoot (joystick.shaped (OI::kShootLeftAxis) * v, joystick.shaped (OI::kShootRightAxis) * v);
 
-    moveBallToShooter (joystick.GetRawAxis (OI::kEnableActuator));
+    moveBallToShooter (joystick.shaped (OI::kEnableActuator));
+}
+
+//===============================================================================
+// Shooter::smartShoot
+//===============================================================================
+
+///
+/// Sets the speed of the wheels for the distance measured by the
+/// rangefinder, the wheels keep their speed if there is no recent
+/// measurement
+///
+void Shooter::smartShoot() {
+    RangeSample sample;
+    if (m_rangefinder.fresh (sample))
+        shoot (sample.inches);
 }
 
 //===============================================================================
 // Shooter::moveBallToShooter
 //===============================================================================
 
+///
+/// Runs the actuator at 60% of the given output
+///
 void Shooter::moveBallToShooter (float act_output) {
-    m_actuator->Set (ADJUST_INPUT (act_output * 0.6, 0));
+    m_actuator.Set (act_output * 0.6);
 }
 
 //===============================================================================
-// Shooter::getInitialVelocity
+// Shooter::readyToFire
 //===============================================================================
 
-float Shooter::getInitialVelocity (float range) {
-    float n = pow (range, 2) * kGRAVITY;
-    float d = (range * sin (2 * kANGLE)) + (2 * kHEIGHT * pow (cos (kANGLE), 2));
+///
+/// Returns true when both wheels are spinning, and are within the tolerance
+/// of their target speed
+///
+bool Shooter::readyToFire() const {
+    if (m_targetLeft == 0 || m_targetRight == 0)
+        return false;
+
+    const float errorLeft  = m_motorLeft.GetSpeed()  - m_targetLeft;
+    const float errorRight = m_motorRight.GetSpeed() - m_targetRight;
+
+    return fabsf (errorLeft)  < Flywheel::kToleranceRPM &&
+           fabsf (errorRight) < Flywheel::kToleranceRPM;
+}
+
+//===============================================================================
+// Shooter::range
+//===============================================================================
+
+///
+/// Returns the latest distance measured by the ultrasonic sensor (without
+/// filter), in inches
+///
+float Shooter::range() {
+    return m_rangefinder.raw();
+}
+
+//===============================================================================
+// Shooter::actuator
+//===============================================================================
+
+float Shooter::actuator() const {
+    return m_actuator.Get();
+}
 
-    float velocity = sqrt (n / d);
-    float friction = velocity * kFRICTION;
+//===============================================================================
+// Shooter::current
+//===============================================================================
+
+///
+/// Returns the current drawn by the flywheel motors (in amps)
+///
+float Shooter::current() const {
+    return m_motorLeft.GetOutputCurrent() + m_motorRight.GetOutputCurrent();
+}
+
+//===============================================================================
+// Shooter::limit
+//===============================================================================
+
+///
+/// Limits the output of the flywheel motors to a fraction of the battery
+/// voltage (see PowerBudget). Scaling the target speed instead would make the
+/// closed loop brake the wheels, drawing even more current. The Talons are
+/// only configured when the limit moves by a step of Power::kPeakVoltageStep.
+///
+void Shooter::limit (float scale) {
+    const double step = Power::kPeakVoltageStep;
+    const double voltage = ceil (scale * Power::kMaxVoltage / step) * step;
+    if (voltage == m_peakVoltage)
+        return;
+
+    m_motorLeft.ConfigPeakOutputVoltage (voltage, -voltage);
+    m_motorRight.ConfigPeakOutputVoltage (voltage, -voltage);
+    m_peakVoltage = voltage;
+}
+
+//===============================================================================
+// Shooter::configure
+//===============================================================================
+
+///
+/// Makes the Talon control the speed of the wheel with its encoder, the
+/// feed-forward gives most of the output and the PID loop corrects the rest.
+/// The wheel coasts while it has no target speed (see setSpeed).
+///
+void Shooter::configure (WinT_Motor* motor) {
+    motor->SetFeedbackDevice (CANTalon::QuadEncoder);
+    motor->ConfigEncoderCodesPerRev (Flywheel::kEncoderCodes);
+    motor->SetPID (Flywheel::kP, Flywheel::kI, Flywheel::kD, Flywheel::kF);
+    motor->ConfigNeutralMode (CANSpeedController::kNeutralMode_Coast);
+    motor->SetControlMode (CANSpeedController::kPercentVbus);
+}
+
+//===============================================================================
+// Shooter::setSpeed
+//===============================================================================
+
+///
+/// Sets the target speed of each wheel, in RPM
+///
+void Shooter::setSpeed (float left, float right) {
+    m_targetLeft = m_motorLeft.GetInverted() ? -left : left;
+    m_targetRight = m_motorRight.GetInverted() ? -right : right;
+
+    setTarget (&m_motorLeft,  OutputFrame::kShooterLeft,  left);
+    setTarget (&m_motorRight, OutputFrame::kShooterRight, right);
+}
+
+//===============================================================================
+// Shooter::setTarget
+//===============================================================================
+
+///
+/// Stages the target speed of a wheel. A target of 0 puts the Talon in
+/// neutral (percent mode, output 0) so that the wheel coasts down, a closed
+/// loop would brake it from full speed, drawing a lot of current.
+///
+void Shooter::setTarget (WinT_Motor* motor, OutputFrame::Channel channel, float rpm) {
+    const CANSpeedController::ControlMode mode = rpm == 0 ? CANSpeedController::kPercentVbus :
+                                                 CANSpeedController::kSpeed;
+    if (motor->GetControlMode() != mode)
+        motor->SetControlMode (mode);
 
-    return velocity + friction;
+    m_outputs->set (channel, rpm);
 }
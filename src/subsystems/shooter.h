@@ -23,22 +23,41 @@
 #pragma once
 
 #include "core/common.h"
+#include "core/inputs.h"
+#include "core/output_frame.h"
+#include "subsystems/rangefinder.h"
+#include "subsystems/shot_table.h"
 
 class Shooter {
   public:
-    explicit Shooter();
+    explicit Shooter (OutputFrame* outputs);
     void shoot (float inches);
     void shoot (float left, float right);
-    void shoot (const Joystick& joystick);
+    void shoot (const JoystickState& joystick);
     void moveBallToShooter (float act_output);
+    void smartShoot();
+
+    bool readyToFire() const;
+    float range();
+    float actuator() const;
+    float current() const;
+
+    void limit (float scale);
 
   private:
-    float getInitialVelocity (float range);
+    void configure (WinT_Motor* motor);
+    void setSpeed (float left, float right);
+    void setTarget (WinT_Motor* motor, OutputFrame::Channel channel, float rpm);
+
+    OutputFrame* m_outputs;
+    ShotTable m_table;
 
-    Talon* m_actuator;
-    WinT_Motor* m_motorLeft;
-    WinT_Motor* m_motorRight;
-    Ultrasonic* m_ultrasonic;
+    Talon m_actuator;
+    WinT_Motor m_motorLeft;
+    WinT_Motor m_motorRight;
+    Rangefinder m_rangefinder;
 
-    float m_maxInitialVelocity;
+    float m_targetLeft;
+    float m_targetRight;
+    double m_peakVoltage;
 };
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "shot_table.h"
+#include "core/common.h"
+
+///
+/// The constants used for calculating the initial velocity and
+/// motor output values based on the projectile motion concepts
+///
+/// Please note that these values are on the metric system, and that the
+/// angle is given in degrees.
+///
+const float kANGLE     = 62.00;
+const float kHEIGHT    = 2.050;
+const float kGRAVITY   = 9.807;
+const float kMAX_RANGE = 1.958;
+const float kFRICTION  = 0.470;
+
+//===============================================================================
+// ShotTable::ShotTable
+//===============================================================================
+
+ShotTable::ShotTable() {
+    const float maxVelocity = initialVelocity (kMAX_RANGE);
+
+    for (int i = 0; i < kEntries; ++i) {
+        float ratio = initialVelocity (i * kStep * 0.0254) / maxVelocity;
+        m_rpm[i] = fmin (ratio, 1) * Flywheel::kMaxRPM;
+    }
+}
+
+//===============================================================================
+// ShotTable::rpm
+//===============================================================================
+
+///
+/// Returns the speed of the wheels (in RPM) needed for the given range, the
+/// range is limited to the range of the table
+///
+float ShotTable::rpm (float inches) const {
+    const float position = fmax (0, fmin (inches, kMaxRange)) / kStep;
+    const int index = (int) fmin (position, kEntries - 2);
+    const float weight = position - index;
+
+    return m_rpm[index] + (m_rpm[index + 1] - m_rpm[index]) * weight;
+}
+
+//===============================================================================
+// ShotTable::initialVelocity
+//===============================================================================
+
+///
+/// Returns the initial velocity (in m/s) that the ball needs to travel the
+/// given distance (in meters)
+///
+float ShotTable::initialVelocity (float range) {
+    const float angle = kANGLE * M_PI / 180;
+
+    float n = pow (range, 2) * kGRAVITY;
+    float d = (range * sin (2 * angle)) + (2 * kHEIGHT * pow (cos (angle), 2));
+
+    float velocity = sqrt (n / d);
+    float friction = velocity * kFRICTION;
+
+    return velocity + friction;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+///
+/// Speed of the shooter wheels needed to score from a given distance.
+///
+/// The projectile motion model is evaluated once, when the table is built,
+/// for ranges from 0 to kMaxRange inches. The speed at any other range is
+/// interpolated between the two closest entries, so shooting does not need
+/// any trigonometry or square roots in the robot loop.
+///
+/// Speeds are scaled so that the maximum range of the model is reached with
+/// the maximum speed of the wheels (Flywheel::kMaxRPM), like the open-loop
+/// output used to be scaled to 1.
+///
+class ShotTable {
+  public:
+    static const int kEntries = 41;
+    static constexpr float kMaxRange = 80;
+    static constexpr float kStep = kMaxRange / (kEntries - 1);
+
+    explicit ShotTable();
+
+    float rpm (float inches) const;
+
+    static float initialVelocity (float meters);
+
+  private:
+    float m_rpm[kEntries];
+};
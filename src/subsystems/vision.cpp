@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "vision.h"
+
+//===============================================================================
+// Vision::Vision
+//===============================================================================
+
+Vision::Vision() :
+    m_camera (Cameras::kVisionCamera),
+    m_thread (&m_camera, m_settings) {}
+
+//===============================================================================
+// Vision::start
+//===============================================================================
+
+void Vision::start() {
+    m_thread.start();
+}
+
+//===============================================================================
+// Vision::stop
+//===============================================================================
+
+///
+/// Stops the capture and processing threads, and waits for them to end
+///
+void Vision::stop() {
+    m_thread.stop();
+}
+
+//===============================================================================
+// Vision::latest
+//===============================================================================
+
+///
+/// Copies the targets of the last processed frame into \a result, returns
+/// false if no frame has been processed yet
+///
+bool Vision::latest (VisionResult& result) {
+    return m_thread.latest (result);
+}
+
+//===============================================================================
+// Vision::target
+//===============================================================================
+
+///
+/// Finds the largest target of the last processed frame, returns false if
+/// there is none. The bearing is measured from the centroid of the target,
+/// in the resized image that the pipeline works on.
+///
+bool Vision::target (VisionTarget& target) {
+    VisionResult result;
+    if (!latest (result) || result.report.count == 0)
+        return false;
+
+    const Target* largest = &result.report.targets[0];
+    for (int i = 1; i < result.report.count; ++i) {
+        if (result.report.targets[i].area > largest->area)
+            largest = &result.report.targets[i];
+    }
+
+    const double width = Cameras::kWidth * m_settings.resizeScale;
+    const double focal = width / 2 / tan (Cameras::kHorizontalFOV / 2 * M_PI / 180);
+
+    target.frame = result.frame;
+    target.timestamp = result.timestamp;
+    target.bearing = atan ((largest->centroidX - width / 2) / focal) * 180 / M_PI;
+    return true;
+}
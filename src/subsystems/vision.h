@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "core/common.h"
+#include "subsystems/camera.h"
+#include "vision/vision_thread.h"
+
+///
+/// Direction of the largest target of a processed frame, the bearing is in
+/// degrees (positive to the right of the camera)
+///
+struct VisionTarget {
+    uint32_t frame;
+    double timestamp;
+    double bearing;
+};
+
+///
+/// Runs the vision pipeline on the frames of the USB camera, in its own
+/// threads. The robot loop only reads the latest result.
+///
+class Vision {
+  public:
+    explicit Vision();
+
+    void start();
+    void stop();
+    bool latest (VisionResult& result);
+    bool target (VisionTarget& target);
+
+  private:
+    PipelineSettings m_settings;
+    Camera m_camera;
+    VisionThread m_thread;
+};
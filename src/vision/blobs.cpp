@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "blobs.h"
+
+#include <string.h>
+#include <algorithm>
+
+const int BlobLabeller::kOutside;
+
+//===============================================================================
+// BlobLabeller::BlobLabeller
+//===============================================================================
+
+BlobLabeller::BlobLabeller() {}
+
+//===============================================================================
+// BlobLabeller::find
+//===============================================================================
+
+void BlobLabeller::find (const Frame& mask, int minArea) {
+    m_runs.clear();
+    m_stats.clear();
+    m_gaps.assign (1, kOutside);
+    m_blobs.clear();
+    m_accepted.clear();
+    m_rows.resize (mask.height + 1);
+
+    /* Like findContours, ignore the pixels at the border of the image */
+    const int width = mask.width - 1;
+    const int height = mask.height - 1;
+
+    for (int y = 0; y < mask.height; ++y) {
+        const uint8_t* row = mask.row (y);
+        const int prevEnd = (int) m_runs.size();
+        int prev = y > 0 ? m_rows[y - 1] : prevEnd;
+
+        m_rows[y] = prevEnd;
+
+        for (int x = 1; y > 0 && y < height && x < width;) {
+            if (!row[x]) {
+                x = skipZeros (row, x + 1, width);
+                continue;
+            }
+
+            Run run;
+            run.x0 = x;
+            while (x < width && row[x])
+                ++x;
+
+            run.x1 = x;
+            run.label = -1;
+            run.gap = -1;
+
+            /* Join the runs of the previous row that touch this one */
+            while (prev < prevEnd && m_runs[prev].x1 < run.x0)
+                ++prev;
+
+            for (int i = prev; i < prevEnd && m_runs[i].x0 <= run.x1; ++i) {
+                int label = root (m_runs[i].label);
+                run.label = run.label < 0 ? label : unite (run.label, label);
+            }
+
+            if (run.label < 0) {
+                Stats stats;
+                stats.parent = (int) m_stats.size();
+                stats.pixels = 0;
+                stats.x0 = run.x0;
+                stats.y0 = y;
+                stats.x1 = run.x1;
+                stats.y1 = y;
+                stats.sumX = 0;
+                stats.sumY = 0;
+                stats.closed = false;
+
+                run.label = stats.parent;
+                m_stats.push_back (stats);
+            }
+
+            /* Accumulate the statistics of the run in its blob */
+            const int length = run.x1 - run.x0;
+            Stats& stats = m_stats[run.label];
+            stats.pixels += length;
+            stats.sumX += (int64_t) length * (run.x0 + run.x1 - 1) / 2;
+            stats.sumY += (int64_t) length * y;
+            stats.x0 = std::min (stats.x0, run.x0);
+            stats.x1 = std::max (stats.x1, run.x1);
+            stats.y1 = y;
+
+            m_runs.push_back (run);
+        }
+
+        if (y > 0) {
+            linkGaps (y);
+            closeRow (y - 1, minArea);
+        }
+    }
+
+    m_rows[mask.height] = (int) m_runs.size();
+    if (mask.height > 0)
+        closeRow (mask.height - 1, minArea);
+
+    for (int label : m_accepted)
+        finish (label);
+}
+
+//===============================================================================
+// BlobLabeller::skipZeros
+//===============================================================================
+
+///
+/// Returns the position of the first non-zero pixel of the row, starting at
+/// x (or end if there is none). Empty areas are skipped eight pixels at a time.
+///
+int BlobLabeller::skipZeros (const uint8_t* row, int x, int end) {
+    uint64_t word;
+    while (x + 8 <= end) {
+        memcpy (&word, row + x, sizeof (word));
+        if (word)
+            break;
+
+        x += 8;
+    }
+
+    while (x < end && !row[x])
+        ++x;
+
+    return x;
+}
+
+//===============================================================================
+// BlobLabeller::count
+//===============================================================================
+
+int BlobLabeller::count() const {
+    return (int) m_blobs.size();
+}
+
+//===============================================================================
+// BlobLabeller::blob
+//===============================================================================
+
+const Blob& BlobLabeller::blob (int index) const {
+    return m_blobs[index];
+}
+
+//===============================================================================
+// BlobLabeller::root
+//===============================================================================
+
+int BlobLabeller::root (int label) {
+    while (m_stats[label].parent != label) {
+        m_stats[label].parent = m_stats[m_stats[label].parent].parent;
+        label = m_stats[label].parent;
+    }
+
+    return label;
+}
+
+//===============================================================================
+// BlobLabeller::unite
+//===============================================================================
+
+int BlobLabeller::unite (int a, int b) {
+    a = root (a);
+    b = root (b);
+    if (a == b)
+        return a;
+
+    if (b < a)
+        std::swap (a, b);
+
+    /* Merge the statistics of b into a */
+    Stats& target = m_stats[a];
+    const Stats& source = m_stats[b];
+
+    target.pixels += source.pixels;
+    target.sumX += source.sumX;
+    target.sumY += source.sumY;
+    target.x0 = std::min (target.x0, source.x0);
+    target.y0 = std::min (target.y0, source.y0);
+    target.x1 = std::max (target.x1, source.x1);
+    target.y1 = std::max (target.y1, source.y1);
+
+    m_stats[b].parent = a;
+    return a;
+}
+
+//===============================================================================
+// BlobLabeller::gapRoot
+//===============================================================================
+
+int BlobLabeller::gapRoot (int gap) {
+    while (m_gaps[gap] != gap) {
+        m_gaps[gap] = m_gaps[m_gaps[gap]];
+        gap = m_gaps[gap];
+    }
+
+    return gap;
+}
+
+//===============================================================================
+// BlobLabeller::uniteGaps
+//===============================================================================
+
+void BlobLabeller::uniteGaps (int a, int b) {
+    a = gapRoot (a);
+    b = gapRoot (b);
+    if (a != b)
+        m_gaps[std::max (a, b)] = std::min (a, b);
+}
+
+//===============================================================================
+// BlobLabeller::linkGaps
+//===============================================================================
+
+///
+/// Labels the gaps between the runs of the given row, and joins them with the
+/// gaps of the previous row that they overlap (the background is 4-connected).
+/// Gaps that reach the space before the first run or after the last run of
+/// the other row are outside of every blob, the others are holes.
+///
+void BlobLabeller::linkGaps (int y) {
+    const int prevBegin = m_rows[y - 1];
+    const int prevEnd = m_rows[y];
+    const int end = (int) m_runs.size();
+    int prev = prevBegin;
+
+    for (int j = prevBegin; j + 1 < prevEnd; ++j) {
+        if (prevEnd == end || m_runs[j].x1 < m_runs[prevEnd].x0
+            || m_runs[j + 1].x0 > m_runs[end - 1].x1)
+            uniteGaps (m_runs[j].gap, kOutside);
+    }
+
+    for (int i = prevEnd; i + 1 < end; ++i) {
+        const int x0 = m_runs[i].x1;
+        const int x1 = m_runs[i + 1].x0;
+        const int gap = (int) m_gaps.size();
+
+        m_gaps.push_back (gap);
+        m_runs[i].gap = gap;
+
+        if (prevBegin == prevEnd || x0 < m_runs[prevBegin].x0 || x1 > m_runs[prevEnd - 1].x1)
+            uniteGaps (gap, kOutside);
+
+        while (prev + 1 < prevEnd && m_runs[prev + 1].x0 <= x0)
+            ++prev;
+
+        for (int j = prev; j + 1 < prevEnd && m_runs[j].x1 < x1; ++j)
+            uniteGaps (gap, m_runs[j].gap);
+    }
+}
+
+//===============================================================================
+// BlobLabeller::closeRow
+//===============================================================================
+
+///
+/// Closes the blobs of the given row that were not extended by the next row,
+/// and keeps the ones that are large enough. The contour of a blob never
+/// encloses more than the box between the centers of its border pixels.
+///
+void BlobLabeller::closeRow (int y, int minArea) {
+    for (int i = m_rows[y]; i < m_rows[y + 1]; ++i) {
+        Stats& stats = m_stats[root (m_runs[i].label)];
+        if (stats.closed || stats.y1 > y)
+            continue;
+
+        stats.closed = true;
+        if ((stats.x1 - stats.x0 - 1) * (stats.y1 - stats.y0) >= minArea)
+            m_accepted.push_back (stats.parent);
+    }
+}
+
+//===============================================================================
+// BlobLabeller::finish
+//===============================================================================
+
+///
+/// Measures a blob like OpenCV measures its contour: the area of the polygon
+/// that joins the centers of its border pixels, and the area of the convex
+/// hull of the pixel centers at the ends of each row
+///
+void BlobLabeller::finish (int label) {
+    const Stats& stats = m_stats[label];
+
+    double area = 0;
+    m_corners.clear();
+
+    for (int y = stats.y0; y <= stats.y1; ++y) {
+        int x0 = stats.x1;
+        int x1 = stats.x0;
+
+        for (int i = m_rows[y]; i < m_rows[y + 1]; ++i) {
+            if (root (m_runs[i].label) == label) {
+                x0 = std::min (x0, m_runs[i].x0);
+                x1 = std::max (x1, m_runs[i].x1);
+            }
+        }
+
+        if (x0 < x1) {
+            ContourPoint ends[2] = { { x0, y }, { x1 - 1, y } };
+            m_corners.insert (m_corners.end(), ends, ends + 2);
+        }
+
+        if (y < stats.y1)
+            area += rowArea (y, label);
+    }
+
+    const double hull = Contours::hullArea (m_corners.data(),
+                                            (int) m_corners.size(),
+                                            m_hull);
+
+    Blob blob;
+    blob.area = area;
+    blob.pixels = stats.pixels;
+    blob.x = stats.x0;
+    blob.y = stats.y0;
+    blob.width = stats.x1 - stats.x0;
+    blob.height = stats.y1 - stats.y0 + 1;
+    blob.centroidX = (double) stats.sumX / stats.pixels;
+    blob.centroidY = (double) stats.sumY / stats.pixels;
+    blob.solidity = hull > 0 ? 100 * area / hull : 100;
+
+    m_blobs.push_back (blob);
+}
+
+//===============================================================================
+// BlobLabeller::rowArea
+//===============================================================================
+
+///
+/// Returns the area of the contour of a blob between the centers of the
+/// given row and the next one. Each pair of touching runs of the two rows
+/// gives a trapezoid: where the ends of the runs are more than one pixel
+/// apart, the contour follows one of the rows and joins the other one with
+/// a diagonal step, so each side is offset by at most one pixel between the
+/// rows. The space between two pairs is outside of the contour, unless it
+/// belongs to a hole (the outer contour of OpenCV encloses its holes).
+///
+double BlobLabeller::rowArea (int y, int label) {
+    double area = 0;
+    int first = m_rows[y + 1];
+    int lastTop = -1;
+    int lastBottom = -1;
+    int lastRightTop = 0;
+    int lastRightBottom = 0;
+
+    for (int i = m_rows[y]; i < m_rows[y + 1]; ++i) {
+        const Run& top = m_runs[i];
+        if (root (top.label) != label)
+            continue;
+
+        while (first < m_rows[y + 2] && m_runs[first].x1 < top.x0)
+            ++first;
+
+        /* Touching runs always belong to the same blob */
+        for (int j = first; j < m_rows[y + 2] && m_runs[j].x0 <= top.x1; ++j) {
+            const Run& bottom = m_runs[j];
+            const int leftTop = std::max (top.x0, bottom.x0 - 1);
+            const int leftBottom = std::max (bottom.x0, top.x0 - 1);
+            const int rightTop = std::min (top.x1 - 1, bottom.x1);
+            const int rightBottom = std::min (bottom.x1 - 1, top.x1);
+
+            area += (rightTop - leftTop + rightBottom - leftBottom) * 0.5;
+
+            /* The gap follows the run that the two pairs do not share */
+            if (lastTop >= 0) {
+                const int gap = lastTop == i ? m_runs[lastBottom].gap : m_runs[lastTop].gap;
+                if (gapRoot (gap) != kOutside)
+                    area += (leftTop - lastRightTop + leftBottom - lastRightBottom) * 0.5;
+            }
+
+            lastTop = i;
+            lastBottom = j;
+            lastRightTop = rightTop;
+            lastRightBottom = rightBottom;
+        }
+    }
+
+    return area;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "vision/frame.h"
+#include "vision/contours.h"
+
+///
+/// Statistics of a connected group of pixels in a mask
+///
+struct Blob {
+    double area;
+    int pixels;
+    int x;
+    int y;
+    int width;
+    int height;
+    double centroidX;
+    double centroidY;
+    double solidity;
+};
+
+///
+/// Single-pass connected component labeller, replaces GRIP's 'Find Contours'
+/// and 'Filter Contours' steps.
+///
+/// The mask is scanned row by row and each row is reduced to runs of
+/// non-zero pixels. Runs that touch a run of the previous row (including
+/// diagonally, like the 8-connected contours of OpenCV) are merged with a
+/// union-find, and the bounding box and centroid of each blob are
+/// accumulated during the scan. The gaps between the runs are merged the
+/// same way, so the gaps that do not reach the outside are known as holes.
+///
+/// A blob is closed as soon as a row does not extend it. Blobs whose bounding
+/// box is smaller than the minimum area are dropped at that point, and only
+/// the remaining ones are measured from their runs: the area of their outer
+/// contour (the polygon that joins the centers of the border pixels, holes
+/// included, as OpenCV measures it) and the area of its convex hull. Point
+/// lists are never built.
+///
+/// Differences with the contour based steps:
+///     - Holes are not reported as separate contours
+///
+/// As with findContours, the pixels at the border of the mask are ignored.
+///
+/// All the buffers are kept between frames, so no memory is allocated once
+/// the first frames have been processed.
+///
+class BlobLabeller {
+  public:
+    explicit BlobLabeller();
+
+    void find (const Frame& mask, int minArea);
+
+    int count() const;
+    const Blob& blob (int index) const;
+
+  private:
+    static const int kOutside = 0;
+
+    struct Run {
+        int x0;
+        int x1;
+        int label;
+        int gap;
+    };
+
+    struct Stats {
+        int parent;
+        int pixels;
+        int x0;
+        int y0;
+        int x1;
+        int y1;
+        int64_t sumX;
+        int64_t sumY;
+        bool closed;
+    };
+
+    static int skipZeros (const uint8_t* row, int x, int end);
+
+    int root (int label);
+    int unite (int a, int b);
+    int gapRoot (int gap);
+    void uniteGaps (int a, int b);
+    void linkGaps (int y);
+    void closeRow (int y, int minArea);
+    void finish (int label);
+    double rowArea (int y, int label);
+
+    std::vector<Run> m_runs;
+    std::vector<int> m_rows;
+    std::vector<Stats> m_stats;
+    std::vector<int> m_gaps;
+    std::vector<int> m_accepted;
+    std::vector<Blob> m_blobs;
+    std::vector<ContourPoint> m_corners;
+    std::vector<ContourPoint> m_hull;
+};
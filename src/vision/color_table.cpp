@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "color_table.h"
+
+#include <string.h>
+#include <algorithm>
+
+//===============================================================================
+// ColorTable::ColorTable
+//===============================================================================
+
+ColorTable::ColorTable (const HSVRange& a, const HSVRange& b) : m_bounds (a, b) {
+    m_ranges[0] = a;
+    m_ranges[1] = b;
+    memset (m_cells, 0, sizeof (m_cells));
+
+    const int step = 1 << kCellShift;
+
+    for (int index = 0; index < kCellCount; ++index) {
+        const int b0 = (index >> (kCellBits * 2)) * step;
+        const int g0 = ((index >> kCellBits) & ((1 << kCellBits) - 1)) * step;
+        const int r0 = (index & ((1 << kCellBits) - 1)) * step;
+
+        /* Skip the cells whose value (the max channel) is outside both ranges */
+        const int vmin = std::max (b0, std::max (g0, r0));
+        const int vmax = vmin + step - 1;
+        if ((vmax <= m_bounds.lower[0][2] || vmin >= m_bounds.upper[0][2]) &&
+            (vmax <= m_bounds.lower[1][2] || vmin >= m_bounds.upper[1][2]))
+            continue;
+
+        /* Convert every color of the cell, until both results are seen */
+        int inside = 0;
+        int outside = 0;
+        for (int i = 0; i < step * step * step && !(inside && outside); ++i) {
+            if (m_bounds.contains (b0 + i / (step * step),
+                                   g0 + (i / step) % step,
+                                   r0 + i % step))
+                ++inside;
+            else
+                ++outside;
+        }
+
+        Cell cell = inside && outside ? kMixed : (inside ? kInside : kOutside);
+        m_cells[index >> 2] |= cell << ((index & 3) * 2);
+    }
+}
+
+//===============================================================================
+// ColorTable::matches
+//===============================================================================
+
+bool ColorTable::matches (const HSVRange& a, const HSVRange& b) const {
+    return memcmp (&m_ranges[0], &a, sizeof (HSVRange)) == 0 &&
+           memcmp (&m_ranges[1], &b, sizeof (HSVRange)) == 0;
+}
+
+//===============================================================================
+// ColorTable::count
+//===============================================================================
+
+int ColorTable::count (Cell cell) const {
+    int total = 0;
+    for (int index = 0; index < kCellCount; ++index) {
+        if (((m_cells[index >> 2] >> ((index & 3) * 2)) & 3) == cell)
+            ++total;
+    }
+
+    return total;
+}
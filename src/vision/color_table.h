@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "vision/threshold.h"
+
+///
+/// Color lookup table compiled from the two 'HSV Threshold' ranges.
+///
+/// The RGB cube is divided in 32x32x32 cells (the 5 high bits of each
+/// channel), and each cell is stored with 2 bits:
+///
+///     - Outside: no color of the cell lies inside of the ranges
+///     - Inside:  every color of the cell lies inside of the ranges
+///     - Mixed:   the cell is crossed by the border of one of the ranges
+///
+/// Most pixels are classified with a single lookup in an 8 KB table (which
+/// stays in the L1 cache), only the pixels that fall in a mixed cell need
+/// the full HSV conversion. The result is the same as the conversion.
+///
+/// The table is generated when it is constructed, by converting every
+/// 8-bit color once (this takes a fraction of a second).
+///
+class ColorTable {
+  public:
+    enum Cell {
+        kOutside = 0,
+        kInside  = 1,
+        kMixed   = 2,
+    };
+
+    static const int kCellBits = 5;
+    static const int kCellShift = 8 - kCellBits;
+    static const int kCellCount = 1 << (kCellBits * 3);
+    static const int kSizeInBytes = kCellCount / 4;
+
+    explicit ColorTable (const HSVRange& a, const HSVRange& b);
+
+    bool matches (const HSVRange& a, const HSVRange& b) const;
+    int count (Cell cell) const;
+
+    inline Cell cell (int b, int g, int r) const {
+        int index = ((b >> kCellShift) << (kCellBits * 2)) |
+                    ((g >> kCellShift) << kCellBits) |
+                    (r >> kCellShift);
+        return (Cell) ((m_cells[index >> 2] >> ((index & 3) * 2)) & 3);
+    }
+
+    inline bool contains (int b, int g, int r) const {
+        Cell c = cell (b, g, r);
+        if (c != kMixed)
+            return c == kInside;
+
+        return m_bounds.contains (b, g, r);
+    }
+
+  private:
+    HSVRange m_ranges[2];
+    ThresholdBounds m_bounds;
+    uint8_t m_cells[kSizeInBytes];
+};
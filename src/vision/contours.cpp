@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "contours.h"
+
+#include <math.h>
+#include <algorithm>
+
+///
+/// Offsets to each of the 8 neighbours of a pixel, starting to the right
+/// and going counter-clockwise (y grows downwards)
+///
+static const int kDX[8] = { 1,  1,  0, -1, -1, -1, 0, 1 };
+static const int kDY[8] = { 0, -1, -1, -1,  0,  1, 1, 1 };
+
+///
+/// Values used to mark the pixels that have already been visited, these are
+/// the same ones used by OpenCV when only a single label is needed
+///
+static const int8_t kVisited  = 2;
+static const int8_t kRightEnd = (int8_t) (2 | -128);
+
+//===============================================================================
+// ContourFinder::ContourFinder
+//===============================================================================
+
+ContourFinder::ContourFinder() : m_width (0) {}
+
+//===============================================================================
+// ContourFinder::find
+//===============================================================================
+
+void ContourFinder::find (const Frame& mask) {
+    const int w = mask.width;
+    const int h = mask.height;
+
+    m_width = w;
+    m_starts.clear();
+    m_points.clear();
+    m_image.resize ((size_t) w * h);
+
+    if (w < 3 || h < 3)
+        return;
+
+    /* Binarize the mask, pixels on the image border are treated as 0 */
+    for (int y = 0; y < h; ++y) {
+        const uint8_t* src = mask.row (y);
+        int8_t* dst = m_image.data() + (size_t) y * w;
+
+        for (int x = 0; x < w; ++x)
+            dst[x] = src[x] != 0;
+
+        dst[0] = 0;
+        dst[w - 1] = 0;
+    }
+
+    std::fill (m_image.begin(), m_image.begin() + w, 0);
+    std::fill (m_image.end() - w, m_image.end(), 0);
+
+    /* Raster scan, looking for the starting points of outer and hole borders */
+    for (int y = 1; y < h - 1; ++y) {
+        const int8_t* row = m_image.data() + (size_t) y * w;
+        int8_t prev = row[0];
+
+        for (int x = 1; x < w; ++x) {
+            int8_t p = row[x];
+            if (p == prev)
+                continue;
+
+            if (prev == 0 && p == 1)
+                follow (x, y, false);
+
+            else if (p == 0 && prev >= 1)
+                follow (x - 1, y, true);
+
+            prev = row[x];
+        }
+    }
+
+    /* OpenCV returns the contours starting from the last one found */
+    const int contours = count();
+    if (contours > 1) {
+        std::vector<ContourPoint> points;
+        std::vector<int> starts;
+        points.reserve (m_points.size());
+        starts.reserve (contours);
+
+        for (int i = contours - 1; i >= 0; --i) {
+            starts.push_back ((int) points.size());
+            points.insert (points.end(),
+                           m_points.begin() + m_starts[i],
+                           m_points.begin() + m_starts[i] + size (i));
+        }
+
+        m_points.swap (points);
+        m_starts.swap (starts);
+    }
+}
+
+//===============================================================================
+// ContourFinder::count
+//===============================================================================
+
+int ContourFinder::count() const {
+    return (int) m_starts.size();
+}
+
+//===============================================================================
+// ContourFinder::size
+//===============================================================================
+
+int ContourFinder::size (int index) const {
+    int end = index + 1 < count() ? m_starts[index + 1] : (int) m_points.size();
+    return end - m_starts[index];
+}
+
+//===============================================================================
+// ContourFinder::points
+//===============================================================================
+
+const ContourPoint* ContourFinder::points (int index) const {
+    return m_points.data() + m_starts[index];
+}
+
+//===============================================================================
+// ContourFinder::follow
+//===============================================================================
+
+///
+/// Suzuki85 border following, a port of OpenCV's icvFetchContour with
+/// CHAIN_APPROX_SIMPLE (a point is only stored when the direction changes)
+///
+void ContourFinder::follow (int x, int y, bool hole) {
+    int deltas[16];
+    for (int k = 0; k < 8; ++k) {
+        deltas[k] = kDX[k] + kDY[k] * m_width;
+        deltas[k + 8] = deltas[k];
+    }
+
+    int8_t* img = m_image.data();
+    const int i0 = y * m_width + x;
+
+    ContourPoint pt = { x, y };
+    m_starts.push_back ((int) m_points.size());
+
+    /* Look for the first non-zero neighbour, going clockwise */
+    int i1 = i0;
+    int s_end = hole ? 0 : 4;
+    int s = s_end;
+    do {
+        s = (s - 1) & 7;
+        i1 = i0 + deltas[s];
+        if (img[i1] != 0)
+            break;
+    } while (s != s_end);
+
+    /* Isolated pixel */
+    if (s == s_end) {
+        img[i0] = kRightEnd;
+        m_points.push_back (pt);
+        return;
+    }
+
+    int i3 = i0;
+    int i4 = i0;
+    int prev_s = s ^ 4;
+
+    for (;;) {
+        s_end = s;
+
+        /* Look for the next border pixel, going counter-clockwise */
+        for (;;) {
+            i4 = i3 + deltas[++s];
+            if (img[i4] != 0)
+                break;
+        }
+
+        s &= 7;
+
+        /* Mark the pixels whose right neighbour is part of the background */
+        if ((unsigned) (s - 1) < (unsigned) s_end)
+            img[i3] = kRightEnd;
+        else if (img[i3] == 1)
+            img[i3] = kVisited;
+
+        if (s != prev_s) {
+            m_points.push_back (pt);
+            prev_s = s;
+        }
+
+        pt.x += kDX[s];
+        pt.y += kDY[s];
+
+        if (i4 == i0 && i3 == i1)
+            break;
+
+        i3 = i4;
+        s = (s + 4) & 7;
+    }
+}
+
+//===============================================================================
+// Contours::area
+//===============================================================================
+
+double Contours::area (const ContourPoint* points, int count) {
+    if (count < 3)
+        return 0;
+
+    double a = 0;
+    ContourPoint prev = points[count - 1];
+    for (int i = 0; i < count; ++i) {
+        a += (double) prev.x * points[i].y - (double) prev.y * points[i].x;
+        prev = points[i];
+    }
+
+    return fabs (a * 0.5);
+}
+
+//===============================================================================
+// Contours::bounds
+//===============================================================================
+
+ContourBounds Contours::bounds (const ContourPoint* points, int count) {
+    int xmin = points[0].x, xmax = points[0].x;
+    int ymin = points[0].y, ymax = points[0].y;
+
+    for (int i = 1; i < count; ++i) {
+        xmin = std::min (xmin, points[i].x);
+        xmax = std::max (xmax, points[i].x);
+        ymin = std::min (ymin, points[i].y);
+        ymax = std::max (ymax, points[i].y);
+    }
+
+    ContourBounds bounds = { xmin, ymin, xmax - xmin + 1, ymax - ymin + 1 };
+    return bounds;
+}
+
+//===============================================================================
+// cross
+//===============================================================================
+
+static inline long cross (const ContourPoint& o,
+                          const ContourPoint& a,
+                          const ContourPoint& b) {
+    return (long) (a.x - o.x) * (b.y - o.y) - (long) (a.y - o.y) * (b.x - o.x);
+}
+
+//===============================================================================
+// Contours::hullArea
+//===============================================================================
+
+///
+/// Builds the convex hull with Andrew's monotone chain algorithm and
+/// returns its area
+///
+double Contours::hullArea (const ContourPoint* points, int count,
+                           std::vector<ContourPoint>& scratch) {
+    if (count < 3)
+        return 0;
+
+    scratch.assign (points, points + count);
+    std::sort (scratch.begin(), scratch.end(),
+    [] (const ContourPoint & a, const ContourPoint & b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+
+    std::vector<ContourPoint>::iterator end = std::unique (scratch.begin(),
+                                                           scratch.end(),
+    [] (const ContourPoint & a, const ContourPoint & b) {
+        return a.x == b.x && a.y == b.y;
+    });
+
+    const int n = (int) (end - scratch.begin());
+    if (n < 3)
+        return 0;
+
+    /* The hull is written after the sorted points */
+    scratch.resize (n * 3);
+    ContourPoint* hull = scratch.data() + n;
+    int k = 0;
+
+    for (int i = 0; i < n; ++i) {
+        while (k >= 2 && cross (hull[k - 2], hull[k - 1], scratch[i]) <= 0)
+            --k;
+
+        hull[k++] = scratch[i];
+    }
+
+    for (int i = n - 2, lower = k + 1; i >= 0; --i) {
+        while (k >= lower && cross (hull[k - 2], hull[k - 1], scratch[i]) <= 0)
+            --k;
+
+        hull[k++] = scratch[i];
+    }
+
+    return area (hull, k - 1);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "vision/frame.h"
+
+struct ContourPoint {
+    int x;
+    int y;
+};
+
+struct ContourBounds {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+///
+/// Native version of GRIP's 'Find Contours' step (with externalOnly set to
+/// false), which calls OpenCV's findContours with RETR_LIST.
+///
+/// The borders are traced with the same algorithm as OpenCV (Suzuki85), so
+/// the outer and hole contours are the same ones that GRIP finds. Straight
+/// horizontal, vertical and diagonal runs are compressed into their end
+/// points, which does not change the area or the convex hull of a contour.
+///
+/// Contours are stored in the same order as OpenCV returns them, which is
+/// the reverse of the order in which they are found while scanning.
+///
+class ContourFinder {
+  public:
+    explicit ContourFinder();
+
+    void find (const Frame& mask);
+
+    int count() const;
+    int size (int index) const;
+    const ContourPoint* points (int index) const;
+
+  private:
+    void follow (int x, int y, bool hole);
+
+    int m_width;
+    std::vector<int8_t> m_image;
+    std::vector<int> m_starts;
+    std::vector<ContourPoint> m_points;
+};
+
+///
+/// Geometry helpers, these match the OpenCV functions used by GRIP's
+/// 'Filter Contours' and 'Publish ContoursReport' steps
+///
+namespace Contours {
+double area (const ContourPoint* points, int count);
+ContourBounds bounds (const ContourPoint* points, int count);
+double hullArea (const ContourPoint* points, int count,
+                 std::vector<ContourPoint>& scratch);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+///
+/// A packed 8-bit image, stored row by row without any padding.
+///
+/// Color frames use three channels in BGR order (the same order used by
+/// OpenCV and GRIP), while binary masks use a single channel in which
+/// every pixel is either 0 or 255.
+///
+/// A frame can also refer to pixels that it does not own (see wrap()), in
+/// which case it can only be used as an input.
+///
+struct Frame {
+    int width;
+    int height;
+    int channels;
+    std::vector<uint8_t> pixels;
+    const uint8_t* external;
+
+    Frame() : width (0), height (0), channels (0), external (nullptr) {}
+
+    ///
+    /// Changes the size of the frame, the pixel buffer is only
+    /// re-allocated when it needs to grow
+    ///
+    void resize (int w, int h, int c) {
+        width = w;
+        height = h;
+        channels = c;
+        external = nullptr;
+        pixels.resize ((size_t) w * h * c);
+    }
+
+    ///
+    /// Makes the frame use the given pixels (for example a memory-mapped
+    /// file) without copying them, they must outlive the frame
+    ///
+    void wrap (const uint8_t* data, int w, int h, int c) {
+        width = w;
+        height = h;
+        channels = c;
+        external = data;
+        pixels.clear();
+    }
+
+    int stride() const {
+        return width * channels;
+    }
+
+    size_t size() const {
+        return (size_t) height * stride();
+    }
+
+    const uint8_t* data() const {
+        return external ? external : pixels.data();
+    }
+
+    uint8_t* row (int y) {
+        return pixels.data() + (size_t) y * stride();
+    }
+
+    const uint8_t* row (int y) const {
+        return data() + (size_t) y * stride();
+    }
+};
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "vision/frame.h"
+
+///
+/// A camera (or anything that behaves like one) that feeds a VisionThread
+///
+class FrameSource {
+  public:
+    enum Status {
+        kGrabbed,
+        kRetry,
+        kEnded,
+    };
+
+    virtual ~FrameSource() {}
+
+    ///
+    /// Size of the BGR frames given by grab(), used to allocate the frame
+    /// buffers before the capture starts
+    ///
+    virtual int width() const = 0;
+    virtual int height() const = 0;
+
+    ///
+    /// Waits for the next image and writes it into \a frame, which already
+    /// has the size given by width() and height(). The capture time (in
+    /// seconds, on the clock used by the caller) is stored in \a timestamp.
+    ///
+    /// Returns kGrabbed when the frame was written, kRetry when no usable
+    /// image was given this time (the next call may give one), and kEnded
+    /// when no more images can be captured.
+    ///
+    virtual Status grab (Frame& frame, double& timestamp) = 0;
+};
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "fused.h"
+#include "threshold.h"
+
+#include <string.h>
+
+#if defined (__SSE2__)
+#  define FUSED_SSE2 1
+#  include <emmintrin.h>
+#  if defined (__GNUC__)
+#    define FUSED_AVX2 1
+#    include <immintrin.h>
+#  endif
+#endif
+
+//===============================================================================
+// classify
+//===============================================================================
+
+static inline uint8_t classify (int b, int g, int r,
+                                const ThresholdBounds& bounds) {
+    return bounds.contains (b, g, r) ? 255 : 0;
+}
+
+///
+/// The SIMD versions compute the HSV conversion with floats. This is still
+/// exact, because:
+///
+///     - 1044480 / v and 122880 / diff round to the same values as the
+///       OpenCV division tables for every possible input (checked for all
+///       values from 1 to 255)
+///     - Every product is an integer smaller than 2^24, so it can be
+///       represented exactly by a float
+///
+/// The final rounding shift is done with integers.
+///
+#if FUSED_SSE2
+
+//===============================================================================
+// classifyScalar
+//===============================================================================
+
+static void classifyScalar (const float* b, const float* g, const float* r,
+                            int begin, int end,
+                            const ThresholdBounds& bounds,
+                            uint8_t* dst) {
+    for (int x = begin; x < end; ++x)
+        dst[x] = classify ((int) b[x], (int) g[x], (int) r[x], bounds);
+}
+
+//===============================================================================
+// blend (SSE2)
+//===============================================================================
+
+static inline __m128 blend (__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps (_mm_and_ps (mask, a), _mm_andnot_ps (mask, b));
+}
+
+//===============================================================================
+// inside (SSE2)
+//===============================================================================
+
+static inline __m128i inside (__m128i h, __m128i s, __m128i v,
+                              const ThresholdBounds& bounds, int i) {
+    __m128i m = _mm_and_si128 (
+                    _mm_cmpgt_epi32 (h, _mm_set1_epi32 (bounds.lower[i][0])),
+                    _mm_cmplt_epi32 (h, _mm_set1_epi32 (bounds.upper[i][0])));
+    m = _mm_and_si128 (m, _mm_cmpgt_epi32 (s, _mm_set1_epi32 (bounds.lower[i][1])));
+    m = _mm_and_si128 (m, _mm_cmplt_epi32 (s, _mm_set1_epi32 (bounds.upper[i][1])));
+    m = _mm_and_si128 (m, _mm_cmpgt_epi32 (v, _mm_set1_epi32 (bounds.lower[i][2])));
+    m = _mm_and_si128 (m, _mm_cmplt_epi32 (v, _mm_set1_epi32 (bounds.upper[i][2])));
+    return m;
+}
+
+//===============================================================================
+// classifySSE2
+//===============================================================================
+
+static void classifySSE2 (const float* b, const float* g, const float* r,
+                          int count, const ThresholdBounds& bounds,
+                          uint8_t* dst) {
+    const __m128 one = _mm_set1_ps (1);
+    const __m128 two = _mm_set1_ps (2);
+    const __m128 four = _mm_set1_ps (4);
+    const __m128 sNum = _mm_set1_ps ((float) (255 << HSV::kShift));
+    const __m128 hNum = _mm_set1_ps ((float) ((HSV::kHueRange << HSV::kShift) / 6));
+    const __m128i half = _mm_set1_epi32 (1 << (HSV::kShift - 1));
+    const __m128i hueRange = _mm_set1_epi32 (HSV::kHueRange);
+
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        __m128 B = _mm_loadu_ps (b + x);
+        __m128 G = _mm_loadu_ps (g + x);
+        __m128 R = _mm_loadu_ps (r + x);
+
+        __m128 V = _mm_max_ps (B, _mm_max_ps (G, R));
+        __m128 D = _mm_sub_ps (V, _mm_min_ps (B, _mm_min_ps (G, R)));
+
+        /* Saturation */
+        __m128 sdiv = _mm_cvtepi32_ps (_mm_cvtps_epi32 (
+                                           _mm_div_ps (sNum, _mm_max_ps (V, one))));
+        __m128i S = _mm_cvttps_epi32 (_mm_mul_ps (D, sdiv));
+        S = _mm_srai_epi32 (_mm_add_epi32 (S, half), HSV::kShift);
+
+        /* Hue */
+        __m128 hr = _mm_sub_ps (G, B);
+        __m128 hg = _mm_add_ps (_mm_sub_ps (B, R), _mm_mul_ps (two, D));
+        __m128 hb = _mm_add_ps (_mm_sub_ps (R, G), _mm_mul_ps (four, D));
+        __m128 hn = blend (_mm_cmpeq_ps (V, R), hr,
+                           blend (_mm_cmpeq_ps (V, G), hg, hb));
+
+        __m128 hdiv = _mm_cvtepi32_ps (_mm_cvtps_epi32 (
+                                           _mm_div_ps (hNum, _mm_max_ps (D, one))));
+        __m128i H = _mm_cvttps_epi32 (_mm_mul_ps (hn, hdiv));
+        H = _mm_srai_epi32 (_mm_add_epi32 (H, half), HSV::kShift);
+        H = _mm_add_epi32 (H, _mm_and_si128 (_mm_cmplt_epi32 (H, _mm_setzero_si128()),
+                                             hueRange));
+
+        /* Threshold and pack the 32-bit masks into bytes */
+        __m128i Vi = _mm_cvttps_epi32 (V);
+        __m128i m = _mm_or_si128 (inside (H, S, Vi, bounds, 0),
+                                  inside (H, S, Vi, bounds, 1));
+
+        m = _mm_packs_epi32 (m, m);
+        m = _mm_packs_epi16 (m, m);
+        int bytes = _mm_cvtsi128_si32 (m);
+        memcpy (dst + x, &bytes, sizeof (bytes));
+    }
+
+    classifyScalar (b, g, r, x, count, bounds, dst);
+}
+
+#endif
+
+#if FUSED_AVX2
+
+//===============================================================================
+// blend (AVX2)
+//===============================================================================
+
+__attribute__ ((target ("avx2")))
+static inline __m256 blend (__m256 mask, __m256 a, __m256 b) {
+    return _mm256_blendv_ps (b, a, mask);
+}
+
+//===============================================================================
+// inside (AVX2)
+//===============================================================================
+
+__attribute__ ((target ("avx2")))
+static inline __m256i inside (__m256i h, __m256i s, __m256i v,
+                              const ThresholdBounds& bounds, int i) {
+    __m256i m = _mm256_and_si256 (
+                    _mm256_cmpgt_epi32 (h, _mm256_set1_epi32 (bounds.lower[i][0])),
+                    _mm256_cmpgt_epi32 (_mm256_set1_epi32 (bounds.upper[i][0]), h));
+    m = _mm256_and_si256 (m, _mm256_cmpgt_epi32 (s, _mm256_set1_epi32 (bounds.lower[i][1])));
+    m = _mm256_and_si256 (m, _mm256_cmpgt_epi32 (_mm256_set1_epi32 (bounds.upper[i][1]), s));
+    m = _mm256_and_si256 (m, _mm256_cmpgt_epi32 (v, _mm256_set1_epi32 (bounds.lower[i][2])));
+    m = _mm256_and_si256 (m, _mm256_cmpgt_epi32 (_mm256_set1_epi32 (bounds.upper[i][2]), v));
+    return m;
+}
+
+//===============================================================================
+// classifyAVX2
+//===============================================================================
+
+__attribute__ ((target ("avx2")))
+static void classifyAVX2 (const float* b, const float* g, const float* r,
+                          int count, const ThresholdBounds& bounds,
+                          uint8_t* dst) {
+    const __m256 one = _mm256_set1_ps (1);
+    const __m256 two = _mm256_set1_ps (2);
+    const __m256 four = _mm256_set1_ps (4);
+    const __m256 sNum = _mm256_set1_ps ((float) (255 << HSV::kShift));
+    const __m256 hNum = _mm256_set1_ps ((float) ((HSV::kHueRange << HSV::kShift) / 6));
+    const __m256i half = _mm256_set1_epi32 (1 << (HSV::kShift - 1));
+    const __m256i hueRange = _mm256_set1_epi32 (HSV::kHueRange);
+
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        __m256 B = _mm256_loadu_ps (b + x);
+        __m256 G = _mm256_loadu_ps (g + x);
+        __m256 R = _mm256_loadu_ps (r + x);
+
+        __m256 V = _mm256_max_ps (B, _mm256_max_ps (G, R));
+        __m256 D = _mm256_sub_ps (V, _mm256_min_ps (B, _mm256_min_ps (G, R)));
+
+        /* Saturation */
+        __m256 sdiv = _mm256_round_ps (_mm256_div_ps (sNum, _mm256_max_ps (V, one)),
+                                       _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256i S = _mm256_cvttps_epi32 (_mm256_mul_ps (D, sdiv));
+        S = _mm256_srai_epi32 (_mm256_add_epi32 (S, half), HSV::kShift);
+
+        /* Hue */
+        __m256 hr = _mm256_sub_ps (G, B);
+        __m256 hg = _mm256_add_ps (_mm256_sub_ps (B, R), _mm256_mul_ps (two, D));
+        __m256 hb = _mm256_add_ps (_mm256_sub_ps (R, G), _mm256_mul_ps (four, D));
+        __m256 hn = blend (_mm256_cmp_ps (V, R, _CMP_EQ_OQ), hr,
+                           blend (_mm256_cmp_ps (V, G, _CMP_EQ_OQ), hg, hb));
+
+        __m256 hdiv = _mm256_round_ps (_mm256_div_ps (hNum, _mm256_max_ps (D, one)),
+                                       _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256i H = _mm256_cvttps_epi32 (_mm256_mul_ps (hn, hdiv));
+        H = _mm256_srai_epi32 (_mm256_add_epi32 (H, half), HSV::kShift);
+        H = _mm256_add_epi32 (H, _mm256_and_si256 (
+                                  _mm256_cmpgt_epi32 (_mm256_setzero_si256(), H),
+                                  hueRange));
+
+        /* Threshold and pack the 32-bit masks into bytes */
+        __m256i Vi = _mm256_cvttps_epi32 (V);
+        __m256i m = _mm256_or_si256 (inside (H, S, Vi, bounds, 0),
+                                     inside (H, S, Vi, bounds, 1));
+
+        __m128i packed = _mm_packs_epi32 (_mm256_castsi256_si128 (m),
+                                          _mm256_extracti128_si256 (m, 1));
+        packed = _mm_packs_epi16 (packed, packed);
+        _mm_storel_epi64 (reinterpret_cast<__m128i*> (dst + x), packed);
+    }
+
+    classifyScalar (b, g, r, x, count, bounds, dst);
+}
+
+//===============================================================================
+// hasAVX2
+//===============================================================================
+
+static bool hasAVX2() {
+    static const bool supported = __builtin_cpu_supports ("avx2");
+    return supported;
+}
+
+#endif
+
+//===============================================================================
+// FusedThreshold::FusedThreshold
+//===============================================================================
+
+FusedThreshold::FusedThreshold (Method method) : m_method (method) {}
+
+//===============================================================================
+// FusedThreshold::process
+//===============================================================================
+
+void FusedThreshold::process (const Frame& input,
+                              const HSVRange& a,
+                              const HSVRange& b,
+                              Frame& mask) {
+    mask.resize (input.width / 2, input.height / 2, 1);
+
+    if (m_method == kConversion) {
+        convert (input, ThresholdBounds (a, b), mask);
+        return;
+    }
+
+    if (!m_table || !m_table->matches (a, b))
+        m_table.reset (new ColorTable (a, b));
+
+    lookup (input, mask);
+}
+
+//===============================================================================
+// FusedThreshold::colorTable
+//===============================================================================
+
+const ColorTable* FusedThreshold::colorTable() const {
+    return m_table.get();
+}
+
+//===============================================================================
+// FusedThreshold::lookup
+//===============================================================================
+
+void FusedThreshold::lookup (const Frame& input, Frame& mask) {
+    const ColorTable& table = *m_table;
+
+    for (int y = 0; y < mask.height; ++y) {
+        const uint8_t* s0 = input.row (y * 2);
+        const uint8_t* s1 = input.row (y * 2 + 1);
+        uint8_t* dst = mask.row (y);
+
+        for (int x = 0, i = 0; x < mask.width; ++x, i += 6) {
+            int b = (s0[i + 0] + s0[i + 3] + s1[i + 0] + s1[i + 3] + 2) >> 2;
+            int g = (s0[i + 1] + s0[i + 4] + s1[i + 1] + s1[i + 4] + 2) >> 2;
+            int r = (s0[i + 2] + s0[i + 5] + s1[i + 2] + s1[i + 5] + 2) >> 2;
+            dst[x] = table.contains (b, g, r) ? 255 : 0;
+        }
+    }
+}
+
+//===============================================================================
+// FusedThreshold::convert
+//===============================================================================
+
+void FusedThreshold::convert (const Frame& input,
+                              const ThresholdBounds& bounds,
+                              Frame& mask) {
+    const int width = mask.width;
+
+#if FUSED_SSE2
+    m_planes.resize (width * 3);
+
+    float* B = m_planes.data();
+    float* G = B + width;
+    float* R = G + width;
+#endif
+
+    for (int y = 0; y < mask.height; ++y) {
+        const uint8_t* s0 = input.row (y * 2);
+        const uint8_t* s1 = input.row (y * 2 + 1);
+        uint8_t* dst = mask.row (y);
+
+#if !FUSED_SSE2
+        for (int x = 0, i = 0; x < width; ++x, i += 6) {
+            dst[x] = classify ((s0[i + 0] + s0[i + 3] + s1[i + 0] + s1[i + 3] + 2) >> 2,
+                               (s0[i + 1] + s0[i + 4] + s1[i + 1] + s1[i + 4] + 2) >> 2,
+                               (s0[i + 2] + s0[i + 5] + s1[i + 2] + s1[i + 5] + 2) >> 2,
+                               bounds);
+        }
+#else
+        /* Average each 2x2 block into planar rows */
+        for (int x = 0, i = 0; x < width; ++x, i += 6) {
+            B[x] = (s0[i + 0] + s0[i + 3] + s1[i + 0] + s1[i + 3] + 2) >> 2;
+            G[x] = (s0[i + 1] + s0[i + 4] + s1[i + 1] + s1[i + 4] + 2) >> 2;
+            R[x] = (s0[i + 2] + s0[i + 5] + s1[i + 2] + s1[i + 5] + 2) >> 2;
+        }
+
+#  if FUSED_AVX2
+        if (hasAVX2()) {
+            classifyAVX2 (B, G, R, width, bounds, dst);
+            continue;
+        }
+#  endif
+
+        classifySSE2 (B, G, R, width, bounds, dst);
+#endif
+    }
+}
+
+//===============================================================================
+// FusedThreshold::supports
+//===============================================================================
+
+bool FusedThreshold::supports (const Frame& input, double scale) {
+    return scale == 0.5 &&
+           input.channels == 3 &&
+           input.width % 2 == 0 &&
+           input.height % 2 == 0;
+}
+
+//===============================================================================
+// FusedThreshold::instructionSet
+//===============================================================================
+
+const char* FusedThreshold::instructionSet() {
+#if FUSED_AVX2
+    if (hasAVX2())
+        return "AVX2";
+#endif
+
+#if FUSED_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
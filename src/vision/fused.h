@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "vision/frame.h"
+#include "vision/steps.h"
+#include "vision/color_table.h"
+
+#include <memory>
+
+///
+/// Fused version of the first four steps of the pipeline (resize 0.5,
+/// HSV Threshold A, HSV Threshold B and bitwise_or).
+///
+/// Each pixel of the input frame is read once: every 2x2 block is averaged,
+/// converted to HSV and tested against both ranges, and the result is
+/// written directly to the output mask. Only one row of the downscaled
+/// image is kept in memory, instead of the four full images used by the
+/// step-by-step version.
+///
+/// The output is bit-exact with Steps::resize + Steps::hsvThreshold (x2) +
+/// Steps::bitwiseOr. Each averaged pixel can be classified in two ways:
+///
+///     - kColorTable: with a ColorTable generated from the ranges, which is
+///       re-generated whenever the ranges change (default, fastest)
+///     - kConversion: by converting every pixel to HSV. On x86, the
+///       conversion is vectorized with AVX2 (selected at runtime) or SSE2,
+///       other CPUs use the scalar version
+///
+class FusedThreshold {
+  public:
+    enum Method {
+        kColorTable,
+        kConversion,
+    };
+
+    explicit FusedThreshold (Method method = kColorTable);
+
+    void process (const Frame& input,
+                  const HSVRange& a,
+                  const HSVRange& b,
+                  Frame& mask);
+
+    const ColorTable* colorTable() const;
+
+    static bool supports (const Frame& input, double scale);
+    static const char* instructionSet();
+
+  private:
+    void lookup (const Frame& input, Frame& mask);
+    void convert (const Frame& input, const ThresholdBounds& bounds, Frame& mask);
+
+    Method m_method;
+    std::vector<float> m_planes;
+    std::unique_ptr<ColorTable> m_table;
+};
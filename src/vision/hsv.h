@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+///
+/// Fixed-point BGR to HSV conversion, this produces exactly the same values
+/// as OpenCV's cvtColor (COLOR_BGR2HSV) for 8-bit images, which is what the
+/// 'HSV Threshold' step of GRIP uses internally:
+///
+///     - H goes from 0 to 180
+///     - S goes from 0 to 255
+///     - V goes from 0 to 255
+///
+namespace HSV {
+const int kShift = 12;
+const int kHueRange = 180;
+
+///
+/// Division tables used to avoid divisions in the conversion
+///
+struct Tables {
+    int sdiv[256];
+    int hdiv[256];
+
+    Tables();
+};
+
+extern const Tables kTables;
+
+///
+/// Converts a single BGR pixel to HSV
+///
+inline void fromBGR (int b, int g, int r, int& h, int& s, int& v) {
+    int vmin = b;
+    v = b;
+
+    if (g > v) v = g;
+    if (r > v) v = r;
+    if (g < vmin) vmin = g;
+    if (r < vmin) vmin = r;
+
+    int diff = v - vmin;
+    int vr = v == r ? -1 : 0;
+    int vg = v == g ? -1 : 0;
+
+    s = (diff * kTables.sdiv[v] + (1 << (kShift - 1))) >> kShift;
+    h = (vr & (g - b)) +
+        (~vr & ((vg & (b - r + 2 * diff)) + ((~vg) & (r - g + 4 * diff))));
+    h = (h * kTables.hdiv[diff] + (1 << (kShift - 1))) >> kShift;
+    h += h < 0 ? kHueRange : 0;
+}
+}
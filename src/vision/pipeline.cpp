@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "pipeline.h"
+
+#include <math.h>
+
+//===============================================================================
+// PipelineSettings::PipelineSettings
+//===============================================================================
+
+PipelineSettings::PipelineSettings() {
+    /* CV resize */
+    resizeScale = 0.5;
+
+    /* HSV Threshold (A) */
+    thresholdA.hue[0] = 80.93525179856115;
+    thresholdA.hue[1] = 123.46349745331068;
+    thresholdA.sat[0] = 43.57014388489208;
+    thresholdA.sat[1] = 103.47198641765704;
+    thresholdA.val[0] = 139.88309352517987;
+    thresholdA.val[1] = 185.73005093378612;
+
+    /* HSV Threshold (B) */
+    thresholdB.hue[0] = 63.129496402877706;
+    thresholdB.hue[1] = 95.9592529711375;
+    thresholdB.sat[0] = 165.10791366906474;
+    thresholdB.sat[1] = 255.0;
+    thresholdB.val[0] = 55.03597122302158;
+    thresholdB.val[1] = 161.91850594227503;
+
+    /* CV dilate */
+    dilateIterations = 2;
+
+    /* Filter Contours */
+    minArea      = 400;
+    minWidth     = 0;
+    maxWidth     = 1000;
+    minHeight    = 0;
+    maxHeight    = 1000;
+    solidity[0]  = 0;
+    solidity[1]  = 100;
+}
+
+//===============================================================================
+// Pipeline::Pipeline
+//===============================================================================
+
+Pipeline::Pipeline (const PipelineSettings& settings) : m_settings (settings) {}
+
+//===============================================================================
+// Pipeline::process
+//===============================================================================
+
+void Pipeline::process (const Frame& input, ContoursReport& report) {
+    if (FusedThreshold::supports (input, m_settings.resizeScale)) {
+        m_fused.process (input,
+                         m_settings.thresholdA,
+                         m_settings.thresholdB,
+                         m_mask);
+    }
+
+    else {
+        Steps::resize       (input, m_settings.resizeScale, m_resized);
+        Steps::hsvThreshold (m_resized, m_settings.thresholdA, m_thresholdA);
+        Steps::hsvThreshold (m_resized, m_settings.thresholdB, m_thresholdB);
+        Steps::bitwiseOr    (m_thresholdA, m_thresholdB, m_mask);
+    }
+
+    Steps::dilate       (m_mask, m_settings.dilateIterations, m_scratch, m_dilated);
+
+    m_blobs.find (m_dilated, (int) ceil (m_settings.minArea));
+    filterBlobs (report);
+}
+
+//===============================================================================
+// Pipeline::settings
+//===============================================================================
+
+const PipelineSettings& Pipeline::settings() const {
+    return m_settings;
+}
+
+//===============================================================================
+// Pipeline::maskOutput
+//===============================================================================
+
+const Frame& Pipeline::maskOutput() const {
+    return m_mask;
+}
+
+//===============================================================================
+// Pipeline::dilateOutput
+//===============================================================================
+
+const Frame& Pipeline::dilateOutput() const {
+    return m_dilated;
+}
+
+//===============================================================================
+// Pipeline::accepts
+//===============================================================================
+
+///
+/// Returns true if the blob passes the 'Filter Contours' checks
+///
+bool Pipeline::accepts (const Blob& blob, const PipelineSettings& settings) {
+    if (blob.area < settings.minArea)
+        return false;
+
+    if (blob.width < settings.minWidth || blob.width > settings.maxWidth)
+        return false;
+
+    if (blob.height < settings.minHeight || blob.height > settings.maxHeight)
+        return false;
+
+    return blob.solidity >= settings.solidity[0] && blob.solidity <= settings.solidity[1];
+}
+
+//===============================================================================
+// Pipeline::filterBlobs
+//===============================================================================
+
+///
+/// Writes the blobs that pass the 'Filter Contours' checks to the report
+///
+void Pipeline::filterBlobs (ContoursReport& report) {
+    report.clear();
+
+    for (int i = 0; i < m_blobs.count(); ++i) {
+        const Blob& blob = m_blobs.blob (i);
+        if (!accepts (blob, m_settings))
+            continue;
+
+        Target target;
+        target.area      = blob.area;
+        target.centerX   = blob.x + blob.width / 2.0;
+        target.centerY   = blob.y + blob.height / 2.0;
+        target.width     = blob.width;
+        target.height    = blob.height;
+        target.solidity  = blob.solidity;
+        target.centroidX = blob.centroidX;
+        target.centroidY = blob.centroidY;
+
+        if (!report.append (target))
+            break;
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "vision/frame.h"
+#include "vision/steps.h"
+#include "vision/fused.h"
+#include "vision/report.h"
+#include "vision/blobs.h"
+
+///
+/// Inputs of each step of the pipeline, the default values are the ones
+/// saved in vision/KZ16.grip
+///
+struct PipelineSettings {
+    double resizeScale;
+    HSVRange thresholdA;
+    HSVRange thresholdB;
+    int dilateIterations;
+
+    double minArea;
+    double minWidth;
+    double maxWidth;
+    double minHeight;
+    double maxHeight;
+    double solidity[2];
+
+    PipelineSettings();
+};
+
+///
+/// Native port of the KZ16.grip pipeline:
+///
+///     1. CV resize (0.5, INTER_LINEAR)
+///     2. HSV Threshold (A)
+///     3. HSV Threshold (B)
+///     4. CV bitwise_or (A, B)
+///     5. CV dilate (2 iterations)
+///     6. Find Contours (external only = false)
+///     7. Filter Contours (min area = 400)
+///     8. Publish ContoursReport
+///
+/// Steps 6 and 7 are done by a BlobLabeller, which measures the blobs of the
+/// mask directly instead of tracing their contours, with the same areas and
+/// solidities as the contours (see blobs.h for the differences). The 'min
+/// perimeter' filter is not supported, it is set to 0 in KZ16.grip.
+///
+/// The intermediate images are kept between calls, so processing a frame
+/// does not allocate any memory once the first frame has been processed.
+///
+/// When the input allows it, steps 1 to 4 are replaced by a single pass of
+/// FusedThreshold, which gives the same mask without the intermediate images.
+///
+/// The reported coordinates are relative to the resized image.
+///
+class Pipeline {
+  public:
+    explicit Pipeline (const PipelineSettings& settings = PipelineSettings());
+
+    void process (const Frame& input, ContoursReport& report);
+
+    const PipelineSettings& settings() const;
+    const Frame& maskOutput() const;
+    const Frame& dilateOutput() const;
+
+    static bool accepts (const Blob& blob, const PipelineSettings& settings);
+
+  private:
+    void filterBlobs (ContoursReport& report);
+
+    PipelineSettings m_settings;
+
+    Frame m_resized;
+    Frame m_thresholdA;
+    Frame m_thresholdB;
+    Frame m_mask;
+    Frame m_scratch;
+    Frame m_dilated;
+
+    FusedThreshold m_fused;
+    BlobLabeller m_blobs;
+};
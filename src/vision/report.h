@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+///
+/// Maximum number of targets published for a single frame
+///
+const int kMaxTargets = 32;
+
+///
+/// Describes a single contour, the first fields are the same ones that the
+/// 'Publish ContoursReport' step of KZ16.grip sends to the network tables
+/// (the center is the center of the bounding box, as in GRIP).
+///
+/// The centroid is the average position of the pixels of the target.
+///
+struct Target {
+    float area;
+    float centerX;
+    float centerY;
+    float width;
+    float height;
+    float solidity;
+    float centroidX;
+    float centroidY;
+};
+
+///
+/// The list of targets found in a frame, stored in a fixed-size array so
+/// that a report can be copied around without touching the heap
+///
+struct ContoursReport {
+    int count;
+    Target targets[kMaxTargets];
+
+    ContoursReport() : count (0) {}
+
+    void clear() {
+        count = 0;
+    }
+
+    bool append (const Target& target) {
+        if (count >= kMaxTargets)
+            return false;
+
+        targets[count++] = target;
+        return true;
+    }
+};
+
+///
+/// The report of a processed camera frame, as published by VisionThread
+///
+struct VisionResult {
+    uint32_t frame;
+    double timestamp;
+    double processingMs;
+    ContoursReport report;
+
+    VisionResult() : frame (0), timestamp (0), processingMs (0) {}
+};
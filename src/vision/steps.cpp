@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "steps.h"
+#include "hsv.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#if defined (__SSE2__)
+#  define STEPS_SSE2 1
+#  include <emmintrin.h>
+#elif defined (__ARM_NEON__) || defined (__ARM_NEON)
+#  define STEPS_NEON 1
+#  include <arm_neon.h>
+#endif
+
+///
+/// Number of fractional bits used by the interpolation weights, this is
+/// the same value as INTER_RESIZE_COEF_BITS in OpenCV
+///
+const int kCoefBits  = 11;
+const int kCoefScale = 1 << kCoefBits;
+
+//===============================================================================
+// resizeHalf
+//===============================================================================
+
+///
+/// With a scale of exactly 0.5, the sample point of each output pixel falls
+/// in the middle of a 2x2 block of the input and both weights are 0.5, so
+/// the bilinear interpolation is reduced to a rounded average
+///
+static void resizeHalf (const Frame& input, Frame& output) {
+    const int cn = input.channels;
+    output.resize (input.width / 2, input.height / 2, cn);
+
+    for (int y = 0; y < output.height; ++y) {
+        const uint8_t* a = input.row (y * 2);
+        const uint8_t* b = input.row (y * 2 + 1);
+        uint8_t* dst = output.row (y);
+
+        for (int x = 0; x < output.width * cn; x += cn) {
+            for (int c = 0; c < cn; ++c) {
+                int i = x * 2 + c;
+                dst[x + c] = (a[i] + a[i + cn] + b[i] + b[i + cn] + 2) >> 2;
+            }
+        }
+    }
+}
+
+//===============================================================================
+// interpolationWeights
+//===============================================================================
+
+static void interpolationWeights (int src, int dst, double scale,
+                                  std::vector<int>& offsets,
+                                  std::vector<int>& weights) {
+    offsets.resize (dst);
+    weights.resize (dst * 2);
+
+    for (int i = 0; i < dst; ++i) {
+        float f = (float) ((i + 0.5) / scale - 0.5);
+        int s = (int) floor (f);
+        f -= s;
+
+        if (s < 0) {
+            f = 0;
+            s = 0;
+        }
+
+        if (s >= src - 1) {
+            f = 0;
+            s = src - 1;
+        }
+
+        offsets[i] = s;
+        weights[i * 2 + 0] = (int) lrint ((1.f - f) * kCoefScale);
+        weights[i * 2 + 1] = (int) lrint (f * kCoefScale);
+    }
+}
+
+//===============================================================================
+// Steps::resize
+//===============================================================================
+
+void Steps::resize (const Frame& input, double scale, Frame& output) {
+    if (scale == 0.5 && input.width % 2 == 0 && input.height % 2 == 0) {
+        resizeHalf (input, output);
+        return;
+    }
+
+    const int cn = input.channels;
+    output.resize ((int) lrint (input.width * scale),
+                   (int) lrint (input.height * scale), cn);
+
+    std::vector<int> xofs, alpha, yofs, beta;
+    interpolationWeights (input.width,  output.width,  scale, xofs, alpha);
+    interpolationWeights (input.height, output.height, scale, yofs, beta);
+
+    std::vector<int> rows (output.width * cn * 2);
+    for (int y = 0; y < output.height; ++y) {
+        for (int k = 0; k < 2; ++k) {
+            int sy = std::min (yofs[y] + k, input.height - 1);
+            const uint8_t* src = input.row (sy);
+            int* h = rows.data() + k * output.width * cn;
+
+            for (int x = 0; x < output.width; ++x) {
+                int sx0 = xofs[x] * cn;
+                int sx1 = std::min (xofs[x] + 1, input.width - 1) * cn;
+
+                for (int c = 0; c < cn; ++c) {
+                    h[x * cn + c] = src[sx0 + c] * alpha[x * 2] +
+                                    src[sx1 + c] * alpha[x * 2 + 1];
+                }
+            }
+        }
+
+        uint8_t* dst = output.row (y);
+        const int* h0 = rows.data();
+        const int* h1 = rows.data() + output.width * cn;
+        for (int i = 0; i < output.width * cn; ++i) {
+            int value = (h0[i] * beta[y * 2] + h1[i] * beta[y * 2 + 1] +
+                         (1 << (kCoefBits * 2 - 1))) >> (kCoefBits * 2);
+            dst[i] = (uint8_t) std::max (0, std::min (255, value));
+        }
+    }
+}
+
+//===============================================================================
+// Steps::hsvThreshold
+//===============================================================================
+
+void Steps::hsvThreshold (const Frame& input, const HSVRange& range,
+                          Frame& output) {
+    const int hmin = roundBound (range.hue[0]);
+    const int hmax = roundBound (range.hue[1]);
+    const int smin = roundBound (range.sat[0]);
+    const int smax = roundBound (range.sat[1]);
+    const int vmin = roundBound (range.val[0]);
+    const int vmax = roundBound (range.val[1]);
+
+    output.resize (input.width, input.height, 1);
+
+    const int count = input.width * input.height;
+    const uint8_t* src = input.data();
+    uint8_t* dst = output.pixels.data();
+
+    for (int i = 0; i < count; ++i, src += 3) {
+        int h, s, v;
+        HSV::fromBGR (src[0], src[1], src[2], h, s, v);
+
+        bool inside = h >= hmin && h <= hmax &&
+                      s >= smin && s <= smax &&
+                      v >= vmin && v <= vmax;
+
+        dst[i] = inside ? 255 : 0;
+    }
+}
+
+//===============================================================================
+// Steps::bitwiseOr
+//===============================================================================
+
+void Steps::bitwiseOr (const Frame& a, const Frame& b, Frame& output) {
+    output.resize (a.width, a.height, a.channels);
+
+    const uint8_t* srcA = a.data();
+    const uint8_t* srcB = b.data();
+    const size_t count = a.size();
+
+    for (size_t i = 0; i < count; ++i)
+        output.pixels[i] = srcA[i] | srcB[i];
+}
+
+//===============================================================================
+// maxRows
+//===============================================================================
+
+///
+/// Replaces each pixel of dst with the maximum of itself and the same pixel
+/// of src, 16 pixels at a time when the CPU allows it
+///
+static void maxRows (uint8_t* dst, const uint8_t* src, int count) {
+    int x = 0;
+
+#if STEPS_SSE2
+    for (; x + 16 <= count; x += 16) {
+        __m128i a = _mm_loadu_si128 ((const __m128i*) (dst + x));
+        __m128i b = _mm_loadu_si128 ((const __m128i*) (src + x));
+        _mm_storeu_si128 ((__m128i*) (dst + x), _mm_max_epu8 (a, b));
+    }
+#elif STEPS_NEON
+    for (; x + 16 <= count; x += 16)
+        vst1q_u8 (dst + x, vmaxq_u8 (vld1q_u8 (dst + x), vld1q_u8 (src + x)));
+#endif
+
+    for (; x < count; ++x)
+        dst[x] = std::max (dst[x], src[x]);
+}
+
+//===============================================================================
+// Steps::dilate
+//===============================================================================
+
+void Steps::dilate (const Frame& input, int iterations, Frame& scratch,
+                    Frame& output) {
+    const int w = input.width;
+    const int h = input.height;
+    const int r = std::max (iterations, 0);
+
+    scratch.resize (w, h, 1);
+    output.resize (w, h, 1);
+
+    /*
+     * Pixels outside of the image are ignored (constant border). Each pass
+     * combines whole rows with shifted copies of themselves, instead of
+     * looking at the neighbours of every pixel, so that it can be done with
+     * vector instructions.
+     */
+    for (int y = 0; y < h; ++y) {
+        const uint8_t* src = input.row (y);
+        uint8_t* dst = scratch.row (y);
+        memcpy (dst, src, w);
+
+        for (int i = 1; i <= r && i < w; ++i) {
+            maxRows (dst, src + i, w - i);
+            maxRows (dst + i, src, w - i);
+        }
+    }
+
+    for (int y = 0; y < h; ++y) {
+        uint8_t* dst = output.row (y);
+        const int first = std::max (y - r, 0);
+        const int last = std::min (y + r, h - 1);
+
+        memcpy (dst, scratch.row (first), w);
+        for (int i = first + 1; i <= last; ++i)
+            maxRows (dst, scratch.row (i), w);
+    }
+}
+
+//===============================================================================
+// Steps::roundBound
+//===============================================================================
+
+int Steps::roundBound (double value) {
+    return std::max (0, std::min (255, (int) lrint (value)));
+}
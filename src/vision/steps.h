@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "vision/frame.h"
+
+///
+/// Lower and upper bounds of an 'HSV Threshold' step, these are stored
+/// exactly as they appear in the GRIP project file
+///
+struct HSVRange {
+    double hue[2];
+    double sat[2];
+    double val[2];
+};
+
+///
+/// Native implementations of the GRIP operations used by KZ16.grip.
+///
+/// Each step reads its inputs and writes a new image, just like GRIP does.
+/// The output frames are resized (and only re-allocated when they grow),
+/// so the same frames should be reused between calls.
+///
+namespace Steps {
+///
+/// CV resize with INTER_LINEAR interpolation. The weights are computed in
+/// fixed point in the same way as OpenCV, so a scale of 0.5 results in
+/// the rounded average of each 2x2 block of the input.
+///
+void resize (const Frame& input, double scale, Frame& output);
+
+///
+/// HSV Threshold, the output pixels are set to 255 when the pixel lies
+/// inside of the given range and to 0 otherwise.
+///
+/// The double bounds are rounded to the nearest integer before comparing,
+/// which is what OpenCV's inRange does with 8-bit images.
+///
+void hsvThreshold (const Frame& input, const HSVRange& range, Frame& output);
+
+///
+/// CV bitwise_or of two masks with the same size
+///
+void bitwiseOr (const Frame& a, const Frame& b, Frame& output);
+
+///
+/// CV dilate with the default 3x3 kernel and a constant border, running
+/// n iterations is the same as dilating once with a (2n + 1) square kernel
+///
+void dilate (const Frame& input, int iterations, Frame& scratch, Frame& output);
+
+///
+/// Rounds a GRIP threshold bound in the same way as OpenCV
+///
+int roundBound (double value);
+}
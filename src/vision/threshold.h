@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "vision/hsv.h"
+#include "vision/steps.h"
+
+///
+/// Rounded bounds of the two 'HSV Threshold' steps, used by the kernels
+/// that test both ranges at once.
+///
+/// The bounds are stored as (min - 1) and (max + 1), so that the SIMD
+/// versions can use 'greater than' and 'less than' comparisons.
+///
+struct ThresholdBounds {
+    int lower[2][3];
+    int upper[2][3];
+
+    ThresholdBounds (const HSVRange& a, const HSVRange& b) {
+        const HSVRange* ranges[2] = { &a, &b };
+        for (int i = 0; i < 2; ++i) {
+            lower[i][0] = Steps::roundBound (ranges[i]->hue[0]) - 1;
+            lower[i][1] = Steps::roundBound (ranges[i]->sat[0]) - 1;
+            lower[i][2] = Steps::roundBound (ranges[i]->val[0]) - 1;
+            upper[i][0] = Steps::roundBound (ranges[i]->hue[1]) + 1;
+            upper[i][1] = Steps::roundBound (ranges[i]->sat[1]) + 1;
+            upper[i][2] = Steps::roundBound (ranges[i]->val[1]) + 1;
+        }
+    }
+
+    inline bool inside (int i, int h, int s, int v) const {
+        return h > lower[i][0] && h < upper[i][0] &&
+               s > lower[i][1] && s < upper[i][1] &&
+               v > lower[i][2] && v < upper[i][2];
+    }
+
+    ///
+    /// Converts a BGR pixel to HSV and returns true if it lies inside of
+    /// any of the two ranges
+    ///
+    inline bool contains (int b, int g, int r) const {
+        int h, s, v;
+        HSV::fromBGR (b, g, r, h, s, v);
+        return inside (0, h, s, v) || inside (1, h, s, v);
+    }
+};
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "vision_thread.h"
+
+#include <stdio.h>
+#include <chrono>
+
+///
+/// Time to wait before grabbing again when the source gave no image
+///
+static const std::chrono::milliseconds kRetryDelay (5);
+
+//===============================================================================
+// VisionThread::VisionThread
+//===============================================================================
+
+VisionThread::VisionThread (FrameSource* source, const PipelineSettings& settings) :
+    m_source (source),
+    m_pipeline (settings),
+    m_stop (false),
+    m_capturing (false),
+    m_processing (false),
+    m_captured (0),
+    m_processed (0),
+    m_dropped (0) {
+    for (size_t i = 0; i < kRingSize; ++i)
+        m_ring.slot (i).frame.resize (source->width(), source->height(), 3);
+
+    m_spare.frame.resize (source->width(), source->height(), 3);
+}
+
+//===============================================================================
+// VisionThread::~VisionThread
+//===============================================================================
+
+VisionThread::~VisionThread() {
+    stop();
+}
+
+//===============================================================================
+// VisionThread::start
+//===============================================================================
+
+void VisionThread::start() {
+    if (m_captureThread.joinable() || m_processThread.joinable())
+        return;
+
+    m_stop = false;
+    m_capturing = true;
+    m_processing = true;
+    m_captureThread = std::thread (&VisionThread::capture, this);
+    m_processThread = std::thread (&VisionThread::process, this);
+}
+
+//===============================================================================
+// VisionThread::stop
+//===============================================================================
+
+void VisionThread::stop() {
+    m_stop = true;
+
+    if (m_captureThread.joinable())
+        m_captureThread.join();
+
+    if (m_processThread.joinable())
+        m_processThread.join();
+}
+
+//===============================================================================
+// VisionThread::running
+//===============================================================================
+
+///
+/// Returns true until the source runs out of frames (or stop() is called)
+/// and every captured frame has been handled
+///
+bool VisionThread::running() const {
+    return m_processing;
+}
+
+//===============================================================================
+// VisionThread::latest
+//===============================================================================
+
+///
+/// Copies the result of the last processed frame into \a result, returns
+/// false if no frame has been processed yet. Must always be called from the
+/// same thread.
+///
+bool VisionThread::latest (VisionResult& result) {
+    return m_latest.load (result);
+}
+
+//===============================================================================
+// VisionThread::captured
+//===============================================================================
+
+uint32_t VisionThread::captured() const {
+    return m_captured;
+}
+
+//===============================================================================
+// VisionThread::processed
+//===============================================================================
+
+uint32_t VisionThread::processed() const {
+    return m_processed;
+}
+
+//===============================================================================
+// VisionThread::dropped
+//===============================================================================
+
+///
+/// Number of captured frames that were never processed, either because a
+/// newer frame was available or because the ring was full
+///
+uint32_t VisionThread::dropped() const {
+    return m_dropped;
+}
+
+//===============================================================================
+// VisionThread::capture
+//===============================================================================
+
+///
+/// Grabs frames until the thread is stopped or the source ends. When the
+/// source gives no image, the grab is retried after kRetryDelay, and only
+/// the first failure of a streak is logged.
+///
+void VisionThread::capture() {
+    uint32_t sequence = 0;
+    bool failing = false;
+
+    while (!m_stop) {
+        CapturedFrame* slot = m_ring.claim();
+        CapturedFrame* target = slot ? slot : &m_spare;
+
+        const FrameSource::Status status = m_source->grab (target->frame, target->timestamp);
+        if (status == FrameSource::kEnded)
+            break;
+
+        if (status == FrameSource::kRetry) {
+            if (!failing)
+                printf ("Vision: the camera gave no image, retrying\n");
+
+            failing = true;
+            std::this_thread::sleep_for (kRetryDelay);
+            continue;
+        }
+
+        failing = false;
+
+        target->sequence = sequence++;
+        m_captured.fetch_add (1, std::memory_order_relaxed);
+
+        if (slot)
+            m_ring.publish();
+        else
+            m_dropped.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    m_capturing = false;
+}
+
+//===============================================================================
+// VisionThread::process
+//===============================================================================
+
+void VisionThread::process() {
+    while (!m_stop) {
+        size_t skipped = 0;
+        const CapturedFrame* slot = m_ring.newest (&skipped);
+
+        if (!slot) {
+            if (!m_capturing && !m_ring.front())
+                break;
+
+            std::this_thread::sleep_for (std::chrono::milliseconds (1));
+            continue;
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        m_pipeline.process (slot->frame, m_result.report);
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        m_result.frame = slot->sequence;
+        m_result.timestamp = slot->timestamp;
+        m_result.processingMs = elapsed.count();
+        m_ring.release();
+
+        m_latest.store (m_result);
+        m_dropped.fetch_add ((uint32_t) skipped, std::memory_order_relaxed);
+        m_processed.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    m_processing = false;
+}
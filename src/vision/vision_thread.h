@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "core/spsc_ring.h"
+#include "core/latest_value.h"
+#include "vision/frame_source.h"
+#include "vision/pipeline.h"
+#include "vision/report.h"
+
+///
+/// Runs the vision pipeline away from the robot loop, with two threads:
+///
+///     - The capture thread grabs the frames of a FrameSource into a
+///       preallocated ring buffer
+///     - The processing thread always takes the newest frame of the ring
+///       (older frames are dropped) and runs the pipeline on it
+///
+/// The result of the last processed frame is published in a lock-free slot,
+/// the control loop reads it with latest() without ever waiting.
+///
+/// The frame buffers are allocated when the thread is created and are then
+/// reused. When the processing thread is too slow and the ring is full, the
+/// new frames are captured into a spare buffer and discarded.
+///
+class VisionThread {
+  public:
+    explicit VisionThread (FrameSource* source,
+                           const PipelineSettings& settings = PipelineSettings());
+    ~VisionThread();
+
+    void start();
+    void stop();
+
+    bool running() const;
+    bool latest (VisionResult& result);
+
+    uint32_t captured() const;
+    uint32_t processed() const;
+    uint32_t dropped() const;
+
+  private:
+    struct CapturedFrame {
+        Frame frame;
+        uint32_t sequence;
+        double timestamp;
+    };
+
+    static const size_t kRingSize = 4;
+
+    void capture();
+    void process();
+
+    FrameSource* m_source;
+    Pipeline m_pipeline;
+    VisionResult m_result;
+    CapturedFrame m_spare;
+
+    SpscRing<CapturedFrame, kRingSize> m_ring;
+    LatestValue<VisionResult> m_latest;
+
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_capturing;
+    std::atomic<bool> m_processing;
+    std::atomic<uint32_t> m_captured;
+    std::atomic<uint32_t> m_processed;
+    std::atomic<uint32_t> m_dropped;
+
+    std::thread m_captureThread;
+    std::thread m_processThread;
+};
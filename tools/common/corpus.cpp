@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "corpus.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <jpeglib.h>
+#include <algorithm>
+
+//===============================================================================
+// numericName
+//===============================================================================
+
+static long numericName (const std::string& path) {
+    size_t slash = path.find_last_of ('/');
+    return atol (path.c_str() + (slash == std::string::npos ? 0 : slash + 1));
+}
+
+//===============================================================================
+// Corpus::list
+//===============================================================================
+
+std::vector<std::string> Corpus::list (const std::string& directory) {
+    std::vector<std::string> paths;
+
+    DIR* dir = opendir (directory.c_str());
+    if (!dir)
+        return paths;
+
+    while (struct dirent* entry = readdir (dir)) {
+        const char* ext = strrchr (entry->d_name, '.');
+        if (ext && (strcmp (ext, ".jpg") == 0 || strcmp (ext, ".jpeg") == 0))
+            paths.push_back (directory + "/" + entry->d_name);
+    }
+
+    closedir (dir);
+
+    std::sort (paths.begin(), paths.end(),
+    [] (const std::string & a, const std::string & b) {
+        long na = numericName (a);
+        long nb = numericName (b);
+        return na != nb ? na < nb : a < b;
+    });
+
+    return paths;
+}
+
+//===============================================================================
+// Corpus::decode
+//===============================================================================
+
+bool Corpus::decode (const std::string& path, Frame& frame) {
+    FILE* file = fopen (path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    jpeg_decompress_struct info;
+    jpeg_error_mgr error;
+
+    info.err = jpeg_std_error (&error);
+    jpeg_create_decompress (&info);
+    jpeg_stdio_src (&info, file);
+    jpeg_read_header (&info, TRUE);
+
+    /* libjpeg outputs RGB, we want the same BGR order as OpenCV */
+    info.out_color_space = JCS_RGB;
+    jpeg_start_decompress (&info);
+    frame.resize (info.output_width, info.output_height, 3);
+
+    while (info.output_scanline < info.output_height) {
+        JSAMPROW row = frame.row (info.output_scanline);
+        jpeg_read_scanlines (&info, &row, 1);
+
+        for (int x = 0; x < frame.width * 3; x += 3)
+            std::swap (row[x], row[x + 2]);
+    }
+
+    jpeg_finish_decompress (&info);
+    jpeg_destroy_decompress (&info);
+    fclose (file);
+
+    return true;
+}
+
+//===============================================================================
+// Corpus::load
+//===============================================================================
+
+bool Corpus::load (const std::string& path,
+                   std::vector<CorpusImage>& images) {
+    images.clear();
+
+    if (FrameCache::isCache (path)) {
+        std::shared_ptr<FrameCache> cache (new FrameCache);
+        if (!cache->open (path)) {
+            fprintf (stderr, "Invalid frame cache %s\n", path.c_str());
+            return false;
+        }
+
+        images.resize (cache->count());
+        for (int i = 0; i < cache->count(); ++i) {
+            images[i].name = cache->name (i);
+            images[i].cache = cache;
+            cache->frame (i, images[i].frame);
+        }
+
+        return !images.empty();
+    }
+
+    std::vector<std::string> paths = list (path);
+    images.resize (paths.size());
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        size_t slash = paths[i].find_last_of ('/');
+        images[i].name = paths[i].substr (slash + 1);
+
+        if (!decode (paths[i], images[i].frame)) {
+            fprintf (stderr, "Cannot decode %s\n", paths[i].c_str());
+            return false;
+        }
+    }
+
+    return !images.empty();
+}
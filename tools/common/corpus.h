@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "vision/frame.h"
+#include "common/frame_cache.h"
+
+///
+/// A decoded image of the vision corpus (vision/images). When the corpus is
+/// loaded from a frame cache, the frame points into the cache, which is kept
+/// open as long as the image exists.
+///
+struct CorpusImage {
+    std::string name;
+    Frame frame;
+    std::shared_ptr<const FrameCache> cache;
+};
+
+namespace Corpus {
+///
+/// Default location of the image corpus, relative to the repository root
+///
+const char* const kDefaultDirectory = "vision/images";
+
+///
+/// Returns the paths of the JPEG files in the given directory, sorted by
+/// their numeric file name (0.jpg, 3.jpg, ..., 542.jpg)
+///
+std::vector<std::string> list (const std::string& directory);
+
+///
+/// Decodes a JPEG file into a BGR frame
+///
+bool decode (const std::string& path, Frame& frame);
+
+///
+/// Decodes every image of the given directory, or maps the frames of the
+/// given frame cache (see corpus-pack)
+///
+bool load (const std::string& path, std::vector<CorpusImage>& images);
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "frame_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char kMagic[8] = { 'K', 'Z', 'F', 'R', 'A', 'M', 'E', 'S' };
+static const uint32_t kVersion = 1;
+static const uint64_t kAlignment = 64;
+
+//===============================================================================
+// align
+//===============================================================================
+
+static uint64_t align (uint64_t offset) {
+    return (offset + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+//===============================================================================
+// FrameCache::FrameCache
+//===============================================================================
+
+FrameCache::FrameCache() :
+    m_data (nullptr),
+    m_size (0),
+    m_header (nullptr),
+    m_entries (nullptr) {}
+
+//===============================================================================
+// FrameCache::~FrameCache
+//===============================================================================
+
+FrameCache::~FrameCache() {
+    close();
+}
+
+//===============================================================================
+// FrameCache::open
+//===============================================================================
+
+///
+/// Maps the given file, returns false if it is not a valid frame cache
+///
+bool FrameCache::open (const std::string& path) {
+    close();
+
+    int fd = ::open (path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat (fd, &info) != 0 || (size_t) info.st_size < sizeof (Header)) {
+        ::close (fd);
+        return false;
+    }
+
+    void* data = mmap (nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close (fd);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = (const uint8_t*) data;
+    m_size = info.st_size;
+    m_header = (const Header*) m_data;
+    m_entries = (const Entry*) (m_data + sizeof (Header));
+
+    /* Check the header and the bounds of every frame */
+    bool valid = memcmp (m_header->magic, kMagic, sizeof (kMagic)) == 0 &&
+                 m_header->version == kVersion &&
+                 sizeof (Header) + (uint64_t) m_header->count * sizeof (Entry) <= m_size;
+
+    for (uint32_t i = 0; valid && i < m_header->count; ++i) {
+        const Entry& entry = m_entries[i];
+        const uint64_t size = (uint64_t) entry.width * entry.height * entry.channels;
+        valid = entry.width > 0 && entry.height > 0 && entry.channels > 0 &&
+                entry.offset + size <= m_size;
+    }
+
+    if (!valid)
+        close();
+
+    return valid;
+}
+
+//===============================================================================
+// FrameCache::close
+//===============================================================================
+
+void FrameCache::close() {
+    if (m_data)
+        munmap ((void*) m_data, m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_entries = nullptr;
+}
+
+//===============================================================================
+// FrameCache::count
+//===============================================================================
+
+int FrameCache::count() const {
+    return m_header ? (int) m_header->count : 0;
+}
+
+//===============================================================================
+// FrameCache::name
+//===============================================================================
+
+std::string FrameCache::name (int index) const {
+    const Entry& entry = m_entries[index];
+    return std::string (entry.name, strnlen (entry.name, sizeof (entry.name)));
+}
+
+//===============================================================================
+// FrameCache::frame
+//===============================================================================
+
+///
+/// Makes \a frame point to the pixels of the given frame, nothing is copied
+///
+void FrameCache::frame (int index, Frame& frame) const {
+    const Entry& entry = m_entries[index];
+    frame.wrap (m_data + entry.offset, entry.width, entry.height, entry.channels);
+}
+
+//===============================================================================
+// FrameCache::isCache
+//===============================================================================
+
+///
+/// Returns true if the given path is a file that starts like a frame cache
+///
+bool FrameCache::isCache (const std::string& path) {
+    FILE* file = fopen (path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    char magic[sizeof (kMagic)];
+    bool match = fread (magic, 1, sizeof (magic), file) == sizeof (magic) &&
+                 memcmp (magic, kMagic, sizeof (kMagic)) == 0;
+
+    fclose (file);
+    return match;
+}
+
+//===============================================================================
+// FrameCache::write
+//===============================================================================
+
+bool FrameCache::write (const std::string& path,
+                        const std::vector<std::string>& names,
+                        const std::vector<Frame>& frames) {
+    FILE* file = fopen (path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    Header header;
+    memcpy (header.magic, kMagic, sizeof (kMagic));
+    header.version = kVersion;
+    header.count = (uint32_t) frames.size();
+
+    std::vector<Entry> entries (frames.size());
+    uint64_t offset = align (sizeof (Header) + entries.size() * sizeof (Entry));
+
+    for (size_t i = 0; i < frames.size(); ++i) {
+        Entry& entry = entries[i];
+        memset (&entry, 0, sizeof (entry));
+        strncpy (entry.name, names[i].c_str(), sizeof (entry.name) - 1);
+        entry.width = frames[i].width;
+        entry.height = frames[i].height;
+        entry.channels = frames[i].channels;
+        entry.offset = offset;
+        offset = align (offset + frames[i].size());
+    }
+
+    bool ok = fwrite (&header, sizeof (header), 1, file) == 1 &&
+              fwrite (entries.data(), sizeof (Entry), entries.size(), file) == entries.size();
+
+    static const uint8_t kPadding[kAlignment] = {};
+    for (size_t i = 0; ok && i < frames.size(); ++i) {
+        const size_t padding = entries[i].offset - ftell (file);
+        ok = fwrite (kPadding, 1, padding, file) == padding &&
+             fwrite (frames[i].data(), 1, frames[i].size(), file) == frames[i].size();
+    }
+
+    return fclose (file) == 0 && ok;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "vision/frame.h"
+
+///
+/// Read-only, memory-mapped file holding already decoded frames, so that
+/// the tools do not need to decode the JPEG files of the corpus every time.
+///
+/// The file starts with a header and an index (name, size and offset of each
+/// frame), followed by the pixels of each frame, aligned to 64 bytes. The
+/// frames given by frame() point directly into the mapping.
+///
+class FrameCache {
+  public:
+    explicit FrameCache();
+    ~FrameCache();
+
+    bool open (const std::string& path);
+    void close();
+
+    int count() const;
+    std::string name (int index) const;
+    void frame (int index, Frame& frame) const;
+
+    static bool isCache (const std::string& path);
+    static bool write (const std::string& path,
+                       const std::vector<std::string>& names,
+                       const std::vector<Frame>& frames);
+
+  private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t count;
+    };
+
+    struct Entry {
+        char name[48];
+        int32_t width;
+        int32_t height;
+        int32_t channels;
+        int32_t reserved;
+        uint64_t offset;
+    };
+
+    FrameCache (const FrameCache&) = delete;
+    FrameCache& operator= (const FrameCache&) = delete;
+
+    const uint8_t* m_data;
+    size_t m_size;
+    const Header* m_header;
+    const Entry* m_entries;
+};
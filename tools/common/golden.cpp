@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "golden.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* kHeader =
+    "image,targets,area,centerX,centerY,width,height,solidity,centroidX,centroidY";
+
+//===============================================================================
+// Golden::write
+//===============================================================================
+
+bool Golden::write (const std::string& path, const GoldenRun& run) {
+    FILE* file = fopen (path.c_str(), "w");
+    if (!file)
+        return false;
+
+    fprintf (file, "# vision-replay golden, %zu frames, mean %.3f ms\n",
+             run.names.size(), run.meanMs);
+    fprintf (file, "%s\n", kHeader);
+
+    for (size_t i = 0; i < run.names.size(); ++i) {
+        const ContoursReport& report = run.reports[i];
+        if (report.count == 0)
+            fprintf (file, "%s,0\n", run.names[i].c_str());
+
+        for (int j = 0; j < report.count; ++j) {
+            const Target& t = report.targets[j];
+            fprintf (file, "%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                     run.names[i].c_str(), report.count,
+                     t.area, t.centerX, t.centerY, t.width, t.height,
+                     t.solidity, t.centroidX, t.centroidY);
+        }
+    }
+
+    return fclose (file) == 0;
+}
+
+//===============================================================================
+// Golden::read
+//===============================================================================
+
+bool Golden::read (const std::string& path, GoldenRun& run) {
+    FILE* file = fopen (path.c_str(), "r");
+    if (!file)
+        return false;
+
+    run = GoldenRun();
+
+    char line[512];
+    bool valid = true;
+
+    while (valid && fgets (line, sizeof (line), file)) {
+        if (line[0] == '#') {
+            size_t frames;
+            sscanf (line, "# vision-replay golden, %zu frames, mean %lf ms",
+                    &frames, &run.meanMs);
+            continue;
+        }
+
+        if (strncmp (line, kHeader, strlen (kHeader)) == 0)
+            continue;
+
+        char* comma = strchr (line, ',');
+        if (!comma) {
+            valid = false;
+            continue;
+        }
+
+        std::string name (line, comma - line);
+        if (run.names.empty() || run.names.back() != name) {
+            run.names.push_back (name);
+            run.reports.push_back (ContoursReport());
+        }
+
+        int count = 0;
+        Target t = {};
+        int fields = sscanf (comma + 1, "%d,%f,%f,%f,%f,%f,%f,%f,%f",
+                             &count, &t.area, &t.centerX, &t.centerY, &t.width,
+                             &t.height, &t.solidity, &t.centroidX, &t.centroidY);
+
+        if (fields == 9)
+            run.reports.back().append (t);
+        else
+            valid = fields == 1 && count == 0;
+    }
+
+    fclose (file);
+    return valid;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "vision/report.h"
+
+///
+/// Targets found in each image of the corpus, together with the time that
+/// was needed to process them, as saved in a golden file
+///
+struct GoldenRun {
+    std::vector<std::string> names;
+    std::vector<ContoursReport> reports;
+    double meanMs;
+
+    GoldenRun() : meanMs (0) {}
+};
+
+///
+/// Reads and writes golden files. They are CSV files with one row per
+/// target (or one row with a count of 0 for images without targets):
+///
+///     # vision-replay golden, 390 frames, mean 1.523 ms
+///     image,targets,area,centerX,centerY,width,height,solidity,centroidX,centroidY
+///     0.jpg,0
+///     3.jpg,1,1024.000,54.500,...
+///
+namespace Golden {
+const char* const kDefaultPath = "vision/golden.csv";
+
+bool write (const std::string& path, const GoldenRun& run);
+bool read (const std::string& path, GoldenRun& run);
+}
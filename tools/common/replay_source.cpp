@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "replay_source.h"
+
+#include <string.h>
+#include <thread>
+
+//===============================================================================
+// ReplaySource::ReplaySource
+//===============================================================================
+
+ReplaySource::ReplaySource (const std::vector<CorpusImage>& images,
+                            double fps,
+                            int passes) :
+    m_images (images),
+    m_start (std::chrono::steady_clock::now()),
+    m_period (std::chrono::steady_clock::duration::zero()),
+    m_frames (images.size() * passes),
+    m_next (0) {
+    if (fps > 0)
+        m_period = std::chrono::duration_cast<std::chrono::steady_clock::duration> (
+                       std::chrono::duration<double> (1.0 / fps));
+}
+
+//===============================================================================
+// ReplaySource::width
+//===============================================================================
+
+int ReplaySource::width() const {
+    return m_images.empty() ? 0 : m_images[0].frame.width;
+}
+
+//===============================================================================
+// ReplaySource::height
+//===============================================================================
+
+int ReplaySource::height() const {
+    return m_images.empty() ? 0 : m_images[0].frame.height;
+}
+
+//===============================================================================
+// ReplaySource::grab
+//===============================================================================
+
+FrameSource::Status ReplaySource::grab (Frame& frame, double& timestamp) {
+    if (m_next >= m_frames)
+        return kEnded;
+
+    /* Wait until the camera would have given the frame */
+    std::this_thread::sleep_until (m_start + m_period * m_next);
+
+    const Frame& source = image ((uint32_t) m_next).frame;
+    if (source.width != frame.width || source.height != frame.height)
+        frame.resize (source.width, source.height, source.channels);
+
+    memcpy (frame.pixels.data(), source.data(), source.size());
+    timestamp = now();
+    ++m_next;
+
+    return kGrabbed;
+}
+
+//===============================================================================
+// ReplaySource::now
+//===============================================================================
+
+double ReplaySource::now() const {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+    return elapsed.count();
+}
+
+//===============================================================================
+// ReplaySource::image
+//===============================================================================
+
+///
+/// Returns the image that was given for the frame with the given sequence
+/// number
+///
+const CorpusImage& ReplaySource::image (uint32_t sequence) const {
+    return m_images[sequence % m_images.size()];
+}
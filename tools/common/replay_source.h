@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include "common/corpus.h"
+#include "vision/frame_source.h"
+
+///
+/// Stand-in for the robot camera: plays the decoded corpus images in order,
+/// at a fixed frame rate (or as fast as possible when the rate is 0).
+///
+/// The timestamps are given in seconds since the source was created.
+///
+class ReplaySource : public FrameSource {
+  public:
+    explicit ReplaySource (const std::vector<CorpusImage>& images,
+                           double fps = 30,
+                           int passes = 1);
+
+    int width() const override;
+    int height() const override;
+    Status grab (Frame& frame, double& timestamp) override;
+
+    double now() const;
+    const CorpusImage& image (uint32_t sequence) const;
+
+  private:
+    const std::vector<CorpusImage>& m_images;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::duration m_period;
+    size_t m_frames;
+    size_t m_next;
+};
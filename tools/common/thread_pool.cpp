@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "thread_pool.h"
+
+#include <algorithm>
+
+//===============================================================================
+// ThreadPool::ThreadPool
+//===============================================================================
+
+///
+/// Starts the given number of workers, or one per core when \a threads is 0
+///
+ThreadPool::ThreadPool (int threads) :
+    m_stop (false),
+    m_next (0),
+    m_queued (0),
+    m_pending (0) {
+    if (threads <= 0)
+        threads = std::max (1u, std::thread::hardware_concurrency());
+
+    for (int i = 0; i < threads; ++i)
+        m_queues.push_back (std::unique_ptr<Queue> (new Queue));
+
+    for (int i = 0; i < threads; ++i)
+        m_threads.push_back (std::thread (&ThreadPool::run, this, i));
+}
+
+//===============================================================================
+// ThreadPool::~ThreadPool
+//===============================================================================
+
+ThreadPool::~ThreadPool() {
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_stop = true;
+    }
+
+    m_wakeUp.notify_all();
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+//===============================================================================
+// ThreadPool::size
+//===============================================================================
+
+int ThreadPool::size() const {
+    return (int) m_threads.size();
+}
+
+//===============================================================================
+// ThreadPool::submit
+//===============================================================================
+
+void ThreadPool::submit (const Task& task) {
+    Queue& queue = *m_queues[m_next++ % m_queues.size()];
+
+    {
+        std::lock_guard<std::mutex> lock (queue.mutex);
+        queue.tasks.push_back (task);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        ++m_pending;
+        ++m_queued;
+    }
+
+    m_wakeUp.notify_one();
+}
+
+//===============================================================================
+// ThreadPool::wait
+//===============================================================================
+
+///
+/// Blocks until every submitted task has been run
+///
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_done.wait (lock, [this] { return m_pending == 0; });
+}
+
+//===============================================================================
+// ThreadPool::run
+//===============================================================================
+
+void ThreadPool::run (int worker) {
+    Task task;
+
+    for (;;) {
+        if (pop (worker, task) || steal (worker, task)) {
+            --m_queued;
+            task (worker);
+
+            std::lock_guard<std::mutex> lock (m_mutex);
+            if (--m_pending == 0)
+                m_done.notify_all();
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock (m_mutex);
+        m_wakeUp.wait (lock, [this] { return m_stop || m_queued > 0; });
+
+        if (m_stop)
+            return;
+    }
+}
+
+//===============================================================================
+// ThreadPool::pop
+//===============================================================================
+
+bool ThreadPool::pop (int worker, Task& task) {
+    Queue& queue = *m_queues[worker];
+    std::lock_guard<std::mutex> lock (queue.mutex);
+
+    if (queue.tasks.empty())
+        return false;
+
+    task = std::move (queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+//===============================================================================
+// ThreadPool::steal
+//===============================================================================
+
+bool ThreadPool::steal (int worker, Task& task) {
+    const int count = (int) m_queues.size();
+
+    for (int i = 1; i < count; ++i) {
+        Queue& queue = *m_queues[(worker + i) % count];
+        std::lock_guard<std::mutex> lock (queue.mutex);
+
+        if (!queue.tasks.empty()) {
+            task = std::move (queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+///
+/// Fixed set of worker threads with one task queue per worker.
+///
+/// Submitted tasks are spread over the queues. Each worker takes the tasks
+/// of its own queue from the back (the most recent ones, which are still
+/// in its cache) and, once its queue is empty, steals tasks from the front
+/// of the other queues, so that all the workers stay busy until the end.
+///
+/// Tasks receive the index of the worker that runs them, which lets them
+/// use per-worker buffers without any locking.
+///
+class ThreadPool {
+  public:
+    typedef std::function<void (int)> Task;
+
+    explicit ThreadPool (int threads = 0);
+    ~ThreadPool();
+
+    int size() const;
+    void submit (const Task& task);
+    void wait();
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run (int worker);
+    bool pop (int worker, Task& task);
+    bool steal (int worker, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::atomic<bool> m_stop;
+    std::atomic<unsigned> m_next;
+    std::atomic<int> m_queued;
+    std::atomic<int> m_pending;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::condition_variable m_done;
+};
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+///
+/// Measures elapsed time with the monotonic clock
+///
+class Stopwatch {
+  public:
+    Stopwatch() : m_start (std::chrono::steady_clock::now()) {}
+
+    void restart() {
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    double elapsedMs() const {
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - m_start;
+        return elapsed.count();
+    }
+
+  private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+///
+/// Collects per-frame latencies and reports their distribution
+///
+class LatencyStats {
+  public:
+    void reserve (size_t count) {
+        m_samples.reserve (count);
+    }
+
+    void add (double ms) {
+        m_samples.push_back (ms);
+    }
+
+    size_t count() const {
+        return m_samples.size();
+    }
+
+    double total() const {
+        double sum = 0;
+        for (double sample : m_samples)
+            sum += sample;
+
+        return sum;
+    }
+
+    double mean() const {
+        return m_samples.empty() ? 0 : total() / m_samples.size();
+    }
+
+    ///
+    /// Returns the sample at the given percentile (from 0 to 100)
+    ///
+    double percentile (double p) const {
+        if (m_samples.empty())
+            return 0;
+
+        std::vector<double> sorted (m_samples);
+        size_t index = (size_t) (p / 100.0 * (sorted.size() - 1) + 0.5);
+        std::nth_element (sorted.begin(), sorted.begin() + index, sorted.end());
+        return sorted[index];
+    }
+
+    double fps() const {
+        double ms = total();
+        return ms > 0 ? m_samples.size() * 1000.0 / ms : 0;
+    }
+
+  private:
+    std::vector<double> m_samples;
+};
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+
+#include "common/corpus.h"
+#include "common/frame_cache.h"
+#include "common/timing.h"
+
+///
+/// Decodes the image corpus once and saves the frames in a frame cache,
+/// which the other tools can load (with --images <file>) instead of the
+/// JPEG files.
+///
+/// The load time of the cache is then measured twice: cold (after asking
+/// the kernel to drop the cached pages of the file) and warm.
+///
+/// Usage: corpus-pack [--images <dir>] [--output <file>]
+///
+
+//===============================================================================
+// usage
+//===============================================================================
+
+static int usage (const char* name) {
+    fprintf (stderr, "Usage: %s [--images <dir>] [--output <file>]\n", name);
+    return EXIT_FAILURE;
+}
+
+//===============================================================================
+// dropPages
+//===============================================================================
+
+///
+/// Removes the pages of the file from the page cache, so that the next load
+/// has to read them from the disk
+///
+static void dropPages (const std::string& path) {
+    int fd = open (path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    fdatasync (fd);
+    posix_fadvise (fd, 0, 0, POSIX_FADV_DONTNEED);
+    close (fd);
+}
+
+//===============================================================================
+// load
+//===============================================================================
+
+///
+/// Maps the cache and reads every frame once, returns the time in ms
+///
+static double load (const std::string& path, unsigned& checksum) {
+    Stopwatch watch;
+
+    std::vector<CorpusImage> images;
+    if (!Corpus::load (path, images))
+        return -1;
+
+    for (const CorpusImage& image : images) {
+        const uint8_t* data = image.frame.data();
+        for (size_t i = 0; i < image.frame.size(); i += 4096)
+            checksum += data[i];
+    }
+
+    return watch.elapsedMs();
+}
+
+//===============================================================================
+// Main entry point
+//===============================================================================
+
+int main (int argc, char** argv) {
+    std::string directory = Corpus::kDefaultDirectory;
+    std::string output = "build/corpus.frames";
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp (argv[i], "--images") == 0 && i + 1 < argc)
+            directory = argv[++i];
+
+        else if (strcmp (argv[i], "--output") == 0 && i + 1 < argc)
+            output = argv[++i];
+
+        else
+            return usage (argv[0]);
+    }
+
+    Stopwatch decode;
+    std::vector<CorpusImage> images;
+    if (!Corpus::load (directory, images)) {
+        fprintf (stderr, "No images found in %s\n", directory.c_str());
+        return EXIT_FAILURE;
+    }
+
+    const double decodeMs = decode.elapsedMs();
+
+    std::vector<std::string> names;
+    std::vector<Frame> frames;
+    size_t bytes = 0;
+
+    for (const CorpusImage& image : images) {
+        names.push_back (image.name);
+        frames.push_back (image.frame);
+        bytes += image.frame.size();
+    }
+
+    if (!FrameCache::write (output, names, frames)) {
+        fprintf (stderr, "Cannot write %s\n", output.c_str());
+        return EXIT_FAILURE;
+    }
+
+    unsigned checksum = 0;
+    dropPages (output);
+    const double coldMs = load (output, checksum);
+    const double warmMs = load (output, checksum);
+
+    printf ("Written:   %s (%zu frames, %.1f MB)\n", output.c_str(), frames.size(),
+            bytes / 1048576.0);
+    printf ("JPEG:      %8.1f ms to decode %s\n", decodeMs, directory.c_str());
+    printf ("Cold:      %8.1f ms to load the cache\n", coldMs);
+    printf ("Warm:      %8.1f ms to load the cache\n", warmMs);
+
+    return coldMs >= 0 && warmMs >= 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <vector>
+
+#include "common/timing.h"
+#include "core/input_shaping.h"
+
+///
+/// Checks the input curves (see InputCurve) and measures how long they take
+/// to shape the inputs.
+///
+/// The cubic curve must give exactly the same values as the ADJUST_INPUT
+/// function it replaced (copied below), for a grid of inputs from -1 to 1
+/// and the inputs around the deadband, with one value at a time and with
+/// arrays. The program fails if any value differs.
+///
+/// The curves are then timed with arrays of the size of a snapshot (both
+/// joysticks) and with large arrays, against the old function.
+///
+/// Usage: input-bench [--iterations <n>]
+///
+
+static const float kDeadband = 0.1f;
+static const int kSnapshotAxes = 12;
+
+//===============================================================================
+// usage
+//===============================================================================
+
+static int usage (const char* name) {
+    fprintf (stderr, "Usage: %s [--iterations <n>]\n", name);
+    return EXIT_FAILURE;
+}
+
+//===============================================================================
+// oldAdjustInput
+//===============================================================================
+
+///
+/// ADJUST_INPUT as it was, with the float overload of abs
+///
+static float oldAdjustInput (float input, float sensitivity) {
+    if (std::abs (input) < std::abs (0.100))
+        return 0;
+
+    float s = std::abs (sensitivity);
+    float final = (s * std::pow (input, 3)) + (1 - s) * input;
+    return final;
+}
+
+//===============================================================================
+// testInputs
+//===============================================================================
+
+///
+/// Returns a grid of inputs from -1 to 1, and the inputs next to the
+/// deadband, zero and the ends (without going past them)
+///
+static std::vector<float> testInputs() {
+    const int kSteps = 1 << 20;
+
+    std::vector<float> inputs;
+    for (int i = -kSteps; i <= kSteps; ++i)
+        inputs.push_back ((float) i / kSteps);
+
+    const float edges[] = { kDeadband, 0, 1 };
+    for (float edge : edges) {
+        float below = edge;
+        float above = edge;
+        for (int i = 0; i < 64; ++i) {
+            below = nextafterf (below, -2);
+            above = nextafterf (above, 2);
+            if (above <= 1) {
+                inputs.push_back (above);
+                inputs.push_back (-above);
+            }
+
+            inputs.push_back (below);
+            inputs.push_back (-below);
+        }
+    }
+
+    return inputs;
+}
+
+//===============================================================================
+// sameBits
+//===============================================================================
+
+static bool sameBits (float a, float b) {
+    return memcmp (&a, &b, sizeof (float)) == 0;
+}
+
+//===============================================================================
+// checkCubic
+//===============================================================================
+
+///
+/// Compares the cubic curve with the old function, returns false if any
+/// value differs
+///
+static bool checkCubic (const std::vector<float>& inputs) {
+    const float sensitivities[] = { 0, 0.2f, 0.5f, 1, -0.2f };
+    std::vector<float> outputs (inputs.size());
+    bool exact = true;
+
+    for (float sensitivity : sensitivities) {
+        const InputCurve curve = InputCurve::cubic (sensitivity, kDeadband);
+        curve.shape (inputs.data(), outputs.data(), (int) inputs.size());
+
+        size_t differences = 0;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const float expected = oldAdjustInput (inputs[i], sensitivity);
+            if (!sameBits (expected, curve.shape (inputs[i])) ||
+                !sameBits (expected, outputs[i])) {
+                if (differences++ == 0)
+                    printf ("Cubic %.2f: %.9g gives %.9g, expected %.9g\n", sensitivity,
+                            inputs[i], outputs[i], expected);
+            }
+        }
+
+        printf ("Cubic %5.2f  %zu inputs, %zu differences\n", sensitivity, inputs.size(),
+                differences);
+        exact &= differences == 0;
+    }
+
+    return exact;
+}
+
+//===============================================================================
+// checkCurves
+//===============================================================================
+
+///
+/// Checks that the expo and table curves keep the inputs as they are with a
+/// sensitivity of 0 and a straight table, and that the single-value and
+/// array versions agree
+///
+static bool checkCurves (const std::vector<float>& inputs) {
+    const float line[InputCurve::kTablePoints] = {
+        -1, -0.75f, -0.5f, -0.25f, 0, 0.25f, 0.5f, 0.75f, 1
+    };
+
+    const InputCurve curves[] = {
+        InputCurve::expo (0, kDeadband),
+        InputCurve::linear (line, kDeadband),
+    };
+
+    const char* names[] = { "Expo", "Table" };
+    std::vector<float> outputs (inputs.size());
+    bool valid = true;
+
+    for (int c = 0; c < 2; ++c) {
+        curves[c].shape (inputs.data(), outputs.data(), (int) inputs.size());
+
+        double maxError = 0;
+        size_t differences = 0;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const float expected = fabsf (inputs[i]) < kDeadband ? 0 : inputs[i];
+            maxError = fmax (maxError, fabs (outputs[i] - expected));
+            differences += !sameBits (outputs[i], curves[c].shape (inputs[i]));
+        }
+
+        printf ("%-11s max error %.2g, %zu differences with one value at a time\n",
+                names[c], maxError, differences);
+        valid &= maxError < 1e-6 && differences == 0;
+    }
+
+    return valid;
+}
+
+//===============================================================================
+// bench
+//===============================================================================
+
+///
+/// Prints the time taken to shape each input, with arrays of the given size
+///
+static void bench (const char* label, int size, int iterations) {
+    const float points[InputCurve::kTablePoints] = {
+        -1, -0.6f, -0.3f, -0.1f, 0, 0.1f, 0.3f, 0.6f, 1
+    };
+
+    std::vector<float> inputs (size);
+    std::vector<float> outputs (size);
+    for (int i = 0; i < size; ++i)
+        inputs[i] = (float) ((i * 7919) % 2001 - 1000) / 1000;
+
+    const int repeats = iterations / size + 1;
+    const double count = (double) repeats * size;
+    volatile float sink = 0;
+
+    Stopwatch stopwatch;
+    for (int r = 0; r < repeats; ++r) {
+        for (int i = 0; i < size; ++i)
+            outputs[i] = oldAdjustInput (inputs[i], 0.2f);
+
+        sink = sink + outputs[r % size];
+    }
+
+    const double old = stopwatch.elapsedMs() * 1e6 / count;
+
+    const InputCurve curves[] = {
+        InputCurve::cubic (0.2f, kDeadband),
+        InputCurve::expo (0.5f, kDeadband),
+        InputCurve::linear (points, kDeadband),
+    };
+
+    double times[3];
+    for (int c = 0; c < 3; ++c) {
+        stopwatch.restart();
+        for (int r = 0; r < repeats; ++r) {
+            curves[c].shape (inputs.data(), outputs.data(), size);
+            sink = sink + outputs[r % size];
+        }
+
+        times[c] = stopwatch.elapsedMs() * 1e6 / count;
+    }
+
+    printf ("%-11s old %6.2f ns   cubic %6.2f ns   expo %6.2f ns   table %6.2f ns\n",
+            label, old, times[0], times[1], times[2]);
+}
+
+//===============================================================================
+// main
+//===============================================================================
+
+int main (int argc, char** argv) {
+    int iterations = 20000000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp (argv[i], "--iterations") == 0 && i + 1 < argc)
+            iterations = atoi (argv[++i]);
+
+        else
+            return usage (argv[0]);
+    }
+
+    const std::vector<float> inputs = testInputs();
+    bool valid = checkCubic (inputs);
+    valid &= checkCurves (inputs);
+
+    bench ("Snapshot", kSnapshotAxes, iterations);
+    bench ("Array", 4096, iterations);
+
+    return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/routine.h"
+
+///
+/// Compiles a text routine into the binary file that the robot loads when
+/// it starts (see Sequencer), or prints a binary routine as text.
+///
+/// Text routines have one command per line, lines starting with # are
+/// ignored. A command that ends with & runs in parallel with the next one:
+///
+///     drive <inches> [timeout]        Drives straight (negative backwards)
+///     turn <degrees> [timeout]        Turns in place (counterclockwise)
+///     spin <inches> [timeout]         Spins the shooter for a range, until
+///                                     the wheels are ready (0 stops them)
+///     feed <output> <seconds>         Runs the shooter actuator
+///     intake <output> <seconds>       Runs the intake
+///     lift up|down <seconds>          Moves the lifter piston
+///     wait <seconds>                  Does nothing
+///
+/// Usage: routine-compile <input.txt> <output.kzr>
+///        routine-compile --print <routine.kzr>
+///
+
+//===============================================================================
+// usage
+//===============================================================================
+
+static int usage (const char* name) {
+    fprintf (stderr, "Usage: %s <input.txt> <output.kzr>\n", name);
+    fprintf (stderr, "       %s --print <routine.kzr>\n", name);
+    return EXIT_FAILURE;
+}
+
+//===============================================================================
+// parseCommand
+//===============================================================================
+
+///
+/// Parses a line of a text routine, returns false if it is not valid
+///
+static bool parseCommand (char* line, RoutineCommand& command) {
+    memset (&command, 0, sizeof (command));
+
+    char* parallel = strrchr (line, '&');
+    if (parallel) {
+        if (parallel[1 + strspn (parallel + 1, " \t\r\n")] != '\0')
+            return false;
+
+        *parallel = '\0';
+        command.flags |= RoutineCommand::kWithNext;
+    }
+
+    char name[16] = "";
+    char value[16] = "";
+    float timeout = 0;
+    const int fields = sscanf (line, "%15s %15s %f", name, value, &timeout);
+
+    int type = 0;
+    while (RoutineFile::name (type) && strcmp (RoutineFile::name (type), name) != 0)
+        ++type;
+
+    if (!RoutineFile::name (type) || fields < 2)
+        return false;
+
+    command.type = type;
+
+    switch (type) {
+        case RoutineCommand::kWait:
+            command.timeout = (float) atof (value);
+            return fields == 2;
+        case RoutineCommand::kLift:
+            if (strcmp (value, "up") != 0 && strcmp (value, "down") != 0)
+                return false;
+
+            command.value = strcmp (value, "up") == 0 ? 1 : -1;
+            break;
+        default:
+            command.value = (float) atof (value);
+            break;
+    }
+
+    command.timeout = fields == 3 ? timeout : 0;
+    return true;
+}
+
+//===============================================================================
+// compile
+//===============================================================================
+
+static int compile (const char* input, const char* output) {
+    FILE* file = fopen (input, "r");
+    if (!file) {
+        fprintf (stderr, "Cannot read %s\n", input);
+        return EXIT_FAILURE;
+    }
+
+    RoutineCommand commands[RoutineFile::kMaxCommands];
+    int count = 0;
+    int number = 0;
+    bool valid = true;
+    char line[256];
+
+    while (fgets (line, sizeof (line), file)) {
+        ++number;
+
+        char* text = line + strspn (line, " \t");
+        if (*text == '#' || *text == '\n' || *text == '\r' || *text == '\0')
+            continue;
+
+        RoutineCommand command;
+        if (!parseCommand (text, command) || count >= RoutineFile::kMaxCommands) {
+            fprintf (stderr, "%s:%d: invalid command\n", input, number);
+            valid = false;
+            continue;
+        }
+
+        commands[count++] = command;
+    }
+
+    fclose (file);
+
+    if (!valid)
+        return EXIT_FAILURE;
+
+    if (!RoutineFile::validate (commands, count)) {
+        fprintf (stderr, "%s: values must be numbers, timed commands need a duration, "
+                 "drives are limited to %g inches and turns to %g degrees, a group can "
+                 "only drive once and the last command cannot end with &\n", input,
+                 RoutineFile::kMaxDistance, RoutineFile::kMaxAngle);
+        return EXIT_FAILURE;
+    }
+
+    if (!RoutineFile::write (output, commands, count)) {
+        fprintf (stderr, "Cannot write %s\n", output);
+        return EXIT_FAILURE;
+    }
+
+    printf ("%s: %d commands\n", output, count);
+    return EXIT_SUCCESS;
+}
+
+//===============================================================================
+// print
+//===============================================================================
+
+static int print (const char* path) {
+    RoutineCommand commands[RoutineFile::kMaxCommands];
+    int count = 0;
+
+    if (!RoutineFile::read (path, commands, count)) {
+        fprintf (stderr, "Cannot read %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const RoutineCommand& command = commands[i];
+        printf ("%s", RoutineFile::name (command.type));
+
+        if (command.type == RoutineCommand::kWait)
+            printf (" %g", command.timeout);
+
+        else if (command.type == RoutineCommand::kLift)
+            printf (" %s %g", command.value > 0 ? "up" : "down", command.timeout);
+
+        else if (command.timeout > 0)
+            printf (" %g %g", command.value, command.timeout);
+
+        else
+            printf (" %g", command.value);
+
+        printf ("%s\n", command.flags & RoutineCommand::kWithNext ? " &" : "");
+    }
+
+    return EXIT_SUCCESS;
+}
+
+//===============================================================================
+// Main entry point
+//===============================================================================
+
+int main (int argc, char** argv) {
+    if (argc == 3 && strcmp (argv[1], "--print") == 0)
+        return print (argv[2]);
+
+    if (argc == 3 && argv[1][0] != '-')
+        return compile (argv[1], argv[2]);
+
+    return usage (argv[0]);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+#include "core/telemetry_log.h"
+
+///
+/// Compares the outputs of two telemetry logs, loop by loop. Used to check
+/// that a log replayed in the simulation (see etc/scripts/replay.sh) still
+/// produces the motor, solenoid and compressor outputs that were recorded.
+///
+/// The program fails when the logs do not have the same number of loops,
+/// or when an output differs by more than the tolerance.
+///
+/// Usage: telemetry-diff <expected> <actual> [--tolerance <value>]
+///
+
+static const int kMaxReported = 10;
+
+///
+/// Names of the motors of TelemetryRecord, in order
+///
+static const char* kMotorNames[TelemetryRecord::kMotors] = {
+    "LeftA", "LeftB", "RightA", "RightB", "ClutchA", "ClutchB",
+    "ShooterLeft", "ShooterRight", "Intake", "Hands", "ShooterActuator"
+};
+
+//===============================================================================
+// usage
+//===============================================================================
+
+static int usage (const char* name) {
+    fprintf (stderr, "Usage: %s <expected> <actual> [--tolerance <value>]\n", name);
+    return EXIT_FAILURE;
+}
+
+//===============================================================================
+// compare
+//===============================================================================
+
+///
+/// Returns the number of outputs that differ between the two records, and
+/// prints them if there were not too many differences before
+///
+static int compare (const TelemetryRecord& a, const TelemetryRecord& b,
+                    float tolerance, int reported) {
+    int differences = 0;
+    char what[256] = "";
+
+    if (a.mode != b.mode) {
+        snprintf (what, sizeof (what), "mode %d != %d", a.mode, b.mode);
+        ++differences;
+    }
+
+    if (a.solenoid != b.solenoid || a.compressor != b.compressor) {
+        snprintf (what, sizeof (what), "pneumatics %d/%d != %d/%d",
+                  a.solenoid, a.compressor, b.solenoid, b.compressor);
+        ++differences;
+    }
+
+    for (int i = 0; i < TelemetryRecord::kMotors; ++i) {
+        if (fabsf (a.motors[i] - b.motors[i]) > tolerance) {
+            snprintf (what, sizeof (what), "%s %.4f != %.4f",
+                      kMotorNames[i], a.motors[i] + 0.0f, b.motors[i] + 0.0f);
+            ++differences;
+        }
+    }
+
+    if (differences > 0 && reported < kMaxReported)
+        printf ("Loop %u (%.3f s): %s\n", a.loop, a.time, what);
+
+    return differences;
+}
+
+//===============================================================================
+// Main entry point
+//===============================================================================
+
+int main (int argc, char** argv) {
+    std::string paths[2];
+    int count = 0;
+    float tolerance = 1e-4f;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp (argv[i], "--tolerance") == 0 && i + 1 < argc)
+            tolerance = (float) atof (argv[++i]);
+
+        else if (argv[i][0] != '-' && count < 2)
+            paths[count++] = argv[i];
+
+        else
+            return usage (argv[0]);
+    }
+
+    if (count != 2)
+        return usage (argv[0]);
+
+    std::vector<TelemetryRecord> logs[2];
+    for (int i = 0; i < 2; ++i) {
+        if (!TelemetryLog::read (paths[i], logs[i])) {
+            fprintf (stderr, "Cannot read %s\n", paths[i].c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    const size_t loops = std::min (logs[0].size(), logs[1].size());
+    int differences = 0;
+    int loopsWithDifferences = 0;
+
+    for (size_t i = 0; i < loops; ++i) {
+        int d = compare (logs[0][i], logs[1][i], tolerance, loopsWithDifferences);
+        differences += d;
+        loopsWithDifferences += d > 0;
+    }
+
+    printf ("Loops:     %zu expected, %zu replayed\n", logs[0].size(), logs[1].size());
+    printf ("Outputs:   %d differences in %d loops\n", differences, loopsWithDifferences);
+
+    const bool same = differences == 0 && logs[0].size() == logs[1].size();
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "common/corpus.h"
+#include "common/timing.h"
+#include "vision/pipeline.h"
+
+///
+/// Measures the per-frame latency of the native vision pipeline over the
+/// image corpus. JPEG decoding is done before the measurements start, so
+/// only the pipeline itself is timed.
+///
+/// Both fused front ends (HSV conversion and color table) are also checked
+/// against the step-by-step version, the program fails if any mask differs.
+///
+/// Usage: vision-bench [--images <dir>] [--passes <n>]
+///
+
+//===============================================================================
+// usage
+//===============================================================================
+
+static int usage (const char* name) {
+    fprintf (stderr, "Usage: %s [--images <dir>] [--passes <n>]\n", name);
+    return EXIT_FAILURE;
+}
+
+//===============================================================================
+// report
+//===============================================================================
+
+static void report (const char* label, const LatencyStats& stats) {
+    printf ("%-10s p50 %7.3f ms   p99 %7.3f ms   mean %7.3f ms   %8.1f fps\n",
+            label,
+            stats.percentile (50),
+            stats.percentile (99),
+            stats.mean(),
+            stats.fps());
+}
+
+//===============================================================================
+// benchPipeline
+//===============================================================================
+
+static void benchPipeline (const std::vector<CorpusImage>& images, int passes) {
+    Pipeline pipeline;
+    ContoursReport contours;
+    LatencyStats stats;
+    stats.reserve (images.size() * passes);
+
+    /* Warm up the caches and the intermediate buffers */
+    for (const CorpusImage& image : images)
+        pipeline.process (image.frame, contours);
+
+    int targets = 0;
+    int framesWithTargets = 0;
+
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const CorpusImage& image : images) {
+            Stopwatch watch;
+            pipeline.process (image.frame, contours);
+            stats.add (watch.elapsedMs());
+
+            if (pass == 0) {
+                targets += contours.count;
+                framesWithTargets += contours.count > 0;
+            }
+        }
+    }
+
+    printf ("Targets:   %d in %d frames\n", targets, framesWithTargets);
+    report ("Pipeline:", stats);
+}
+
+//===============================================================================
+// benchFrontEnd
+//===============================================================================
+
+///
+/// Compares the step-by-step front end (resize, two thresholds and OR) with
+/// both versions of the fused kernel, and checks that all masks are identical
+///
+static bool benchFrontEnd (const std::vector<CorpusImage>& images, int passes) {
+    const PipelineSettings settings;
+    Frame resized, a, b, reference, converted, lookup;
+    FusedThreshold conversion (FusedThreshold::kConversion);
+    FusedThreshold table (FusedThreshold::kColorTable);
+
+    /* Generate the color table before starting the measurements */
+    Stopwatch build;
+    table.process (images[0].frame, settings.thresholdA, settings.thresholdB, lookup);
+    double buildMs = build.elapsedMs();
+
+    LatencyStats stepsStats;
+    LatencyStats conversionStats;
+    LatencyStats tableStats;
+    int mismatches = 0;
+    long mixedPixels = 0;
+    long pixels = 0;
+
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const CorpusImage& image : images) {
+            Stopwatch watch;
+            Steps::resize       (image.frame, settings.resizeScale, resized);
+            Steps::hsvThreshold (resized, settings.thresholdA, a);
+            Steps::hsvThreshold (resized, settings.thresholdB, b);
+            Steps::bitwiseOr    (a, b, reference);
+            stepsStats.add (watch.elapsedMs());
+
+            watch.restart();
+            conversion.process (image.frame, settings.thresholdA, settings.thresholdB,
+                                converted);
+            conversionStats.add (watch.elapsedMs());
+
+            watch.restart();
+            table.process (image.frame, settings.thresholdA, settings.thresholdB, lookup);
+            tableStats.add (watch.elapsedMs());
+
+            if (pass > 0)
+                continue;
+
+            if (converted.pixels != reference.pixels || lookup.pixels != reference.pixels) {
+                fprintf (stderr, "Fused mask differs for %s\n", image.name.c_str());
+                ++mismatches;
+            }
+
+            for (int i = 0; i < resized.width * resized.height; ++i) {
+                const uint8_t* p = resized.pixels.data() + i * 3;
+                mixedPixels += table.colorTable()->cell (p[0], p[1], p[2]) ==
+                               ColorTable::kMixed;
+            }
+
+            pixels += resized.width * resized.height;
+        }
+    }
+
+    const ColorTable* colors = table.colorTable();
+
+    printf ("\nFront end (resize + 2x HSV threshold + OR):\n");
+    report ("Steps:", stepsStats);
+    report ("HSV:", conversionStats);
+    report ("Table:", tableStats);
+    printf ("Speedup:   %.2fx with HSV conversion (%s), %.2fx with color table\n",
+            stepsStats.mean() / conversionStats.mean(),
+            FusedThreshold::instructionSet(),
+            stepsStats.mean() / tableStats.mean());
+    printf ("Table:     %d bytes, %d inside / %d mixed of %d cells, built in %.1f ms\n",
+            ColorTable::kSizeInBytes,
+            colors->count (ColorTable::kInside),
+            colors->count (ColorTable::kMixed),
+            ColorTable::kCellCount,
+            buildMs);
+    printf ("           %.3f%% of the pixels needed the HSV conversion\n",
+            100.0 * mixedPixels / pixels);
+    printf ("Exact:     %d/%zu masks differ\n", mismatches, images.size());
+
+    return mismatches == 0;
+}
+
+//===============================================================================
+// filterContours
+//===============================================================================
+
+///
+/// GRIP's 'Filter Contours' step, applied to the output of ContourFinder
+///
+static void filterContours (const ContourFinder& contours,
+                            const PipelineSettings& settings,
+                            std::vector<ContourPoint>& scratch,
+                            ContoursReport& report) {
+    report.clear();
+
+    for (int i = 0; i < contours.count(); ++i) {
+        const ContourPoint* points = contours.points (i);
+        const int size = contours.size (i);
+
+        ContourBounds bb = Contours::bounds (points, size);
+        if (bb.width < settings.minWidth || bb.width > settings.maxWidth)
+            continue;
+
+        if (bb.height < settings.minHeight || bb.height > settings.maxHeight)
+            continue;
+
+        double area = Contours::area (points, size);
+        if (area < settings.minArea)
+            continue;
+
+        double solidity = 100 * area / Contours::hullArea (points, size, scratch);
+        if (solidity < settings.solidity[0] || solidity > settings.solidity[1])
+            continue;
+
+        Target target = {};
+        target.area = area;
+        target.centerX = bb.x + bb.width / 2.0;
+        target.centerY = bb.y + bb.height / 2.0;
+        target.width = bb.width;
+        target.height = bb.height;
+        target.solidity = solidity;
+        report.append (target);
+    }
+}
+
+//===============================================================================
+// benchContours
+//===============================================================================
+
+///
+/// Compares Find Contours + Filter Contours with the blob labeller, on the
+/// dilated masks of every image. A target is considered to be found by both
+/// when their bounding boxes, areas and solidities are the same. The program
+/// fails if the two steps do not find the same targets.
+///
+static bool benchContours (const std::vector<CorpusImage>& images, int passes) {
+    Pipeline pipeline;
+    ContoursReport targets;
+    std::vector<Frame> masks (images.size());
+
+    for (size_t i = 0; i < images.size(); ++i) {
+        pipeline.process (images[i].frame, targets);
+        masks[i] = pipeline.dilateOutput();
+    }
+
+    const PipelineSettings& settings = pipeline.settings();
+    const int minArea = (int) ceil (settings.minArea);
+
+    ContourFinder finder;
+    BlobLabeller labeller;
+    ContoursReport contours;
+    std::vector<ContourPoint> scratch;
+
+    LatencyStats contourStats;
+    LatencyStats blobStats;
+    int contourTargets = 0;
+    int blobTargets = 0;
+    int matched = 0;
+    int mismatches = 0;
+
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const Frame& mask : masks) {
+            Stopwatch watch;
+            finder.find (mask);
+            filterContours (finder, settings, scratch, contours);
+            contourStats.add (watch.elapsedMs());
+
+            watch.restart();
+            labeller.find (mask, minArea);
+            blobStats.add (watch.elapsedMs());
+
+            if (pass > 0)
+                continue;
+
+            int accepted = 0;
+            for (int j = 0; j < labeller.count(); ++j)
+                accepted += Pipeline::accepts (labeller.blob (j), settings);
+
+            int found = 0;
+            for (int i = 0; i < contours.count; ++i) {
+                const Target& t = contours.targets[i];
+                for (int j = 0; j < labeller.count(); ++j) {
+                    const Blob& b = labeller.blob (j);
+                    if (Pipeline::accepts (b, settings) &&
+                        b.width == t.width && b.height == t.height &&
+                        b.x + b.width / 2.0 == t.centerX &&
+                        b.y + b.height / 2.0 == t.centerY &&
+                        (float) b.area == t.area && (float) b.solidity == t.solidity) {
+                        ++found;
+                        break;
+                    }
+                }
+            }
+
+            contourTargets += contours.count;
+            blobTargets += accepted;
+            matched += found;
+            mismatches += found != contours.count || found != accepted;
+        }
+    }
+
+    printf ("\nFind + filter contours (on the dilated masks):\n");
+    report ("Contours:", contourStats);
+    report ("Blobs:", blobStats);
+    printf ("Speedup:   %.2fx\n", contourStats.mean() / blobStats.mean());
+    printf ("Targets:   %d contours, %d blobs, %d found by both\n",
+            contourTargets, blobTargets, matched);
+    printf ("Exact:     %d/%zu masks with different targets\n", mismatches, masks.size());
+
+    return mismatches == 0;
+}
+
+//===============================================================================
+// Main entry point
+//===============================================================================
+
+int main (int argc, char** argv) {
+    std::string directory = Corpus::kDefaultDirectory;
+    int passes = 5;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp (argv[i], "--images") == 0 && i + 1 < argc)
+            directory = argv[++i];
+
+        else if (strcmp (argv[i], "--passes") == 0 && i + 1 < argc)
+            passes = atoi (argv[++i]);
+
+        else
+            return usage (argv[0]);
+    }
+
+    Stopwatch load;
+    std::vector<CorpusImage> images;
+    if (!Corpus::load (directory, images)) {
+        fprintf (stderr, "No images found in %s\n", directory.c_str());
+        return EXIT_FAILURE;
+    }
+
+    printf ("Frames:    %zu (%d passes, %dx%d), loaded in %.1f ms\n", images.size(), passes,
+            images[0].frame.width, images[0].frame.height, load.elapsedMs());
+
+    benchPipeline (images, passes);
+    bool exact = benchFrontEnd (images, passes);
+    exact &= benchContours (images, passes);
+
+    return exact ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <thread>
+
+#include "common/corpus.h"
+#include "common/golden.h"
+#include "common/timing.h"
+#include "vision/pipeline.h"
+
+///
+/// Regression gate for the vision pipeline: streams the image corpus
+/// through the pipeline and compares the targets of every frame with the
+/// ones saved in a golden file, together with the processing time.
+///
+/// The golden file is written when it does not exist yet, or when --update
+/// is given. The program fails when a detection changed, or when the mean
+/// processing time grew more than --max-slowdown percent (if given).
+///
+/// Frames are processed as fast as possible, unless a frame rate is set
+/// with --fps (the waits are not included in the measurements).
+///
+
+static const float kTolerance = 0.0015f;
+
+//===============================================================================
+// usage
+//===============================================================================
+
+static int usage (const char* name) {
+    fprintf (stderr, "Usage: %s [--images <dir>] [--golden <file>] [--update] "
+             "[--fps <n>] [--passes <n>] [--max-slowdown <percent>]\n", name);
+    return EXIT_FAILURE;
+}
+
+//===============================================================================
+// replay
+//===============================================================================
+
+static void replay (const std::vector<CorpusImage>& images,
+                    double fps,
+                    int passes,
+                    GoldenRun& run) {
+    Pipeline pipeline;
+    LatencyStats stats;
+    stats.reserve (images.size() * passes);
+
+    run.names.resize (images.size());
+    run.reports.resize (images.size());
+
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    std::chrono::duration<double> period (fps > 0 ? 1.0 / fps : 0);
+
+    for (int pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < images.size(); ++i) {
+            if (fps > 0) {
+                next += std::chrono::duration_cast<std::chrono::steady_clock::duration> (period);
+                std::this_thread::sleep_until (next);
+            }
+
+            Stopwatch watch;
+            pipeline.process (images[i].frame, run.reports[i]);
+            stats.add (watch.elapsedMs());
+
+            run.names[i] = images[i].name;
+        }
+    }
+
+    run.meanMs = stats.mean();
+    printf ("Replayed:  %zu frames x %d passes, p50 %.3f ms, p99 %.3f ms, mean %.3f ms "
+            "(%.1f fps)\n", images.size(), passes, stats.percentile (50),
+            stats.percentile (99), stats.mean(), stats.fps());
+}
+
+//===============================================================================
+// differs
+//===============================================================================
+
+static bool differs (float a, float b) {
+    return fabsf (a - b) > kTolerance;
+}
+
+//===============================================================================
+// compareTargets
+//===============================================================================
+
+///
+/// Prints the differences between two reports of the same image, returns
+/// true if they are the same
+///
+static bool compareTargets (const std::string& name,
+                            const ContoursReport& golden,
+                            const ContoursReport& current) {
+    if (golden.count != current.count) {
+        printf ("  %s: %d -> %d targets\n", name.c_str(), golden.count, current.count);
+        return false;
+    }
+
+    static const char* kFields[] = {
+        "area", "centerX", "centerY", "width", "height", "solidity", "centroidX", "centroidY"
+    };
+
+    bool same = true;
+    for (int i = 0; i < golden.count; ++i) {
+        const float* a = &golden.targets[i].area;
+        const float* b = &current.targets[i].area;
+
+        for (int f = 0; f < 8; ++f) {
+            if (differs (a[f], b[f])) {
+                printf ("  %s: target %d %s %.3f -> %.3f\n",
+                        name.c_str(), i, kFields[f], a[f], b[f]);
+                same = false;
+            }
+        }
+    }
+
+    return same;
+}
+
+//===============================================================================
+// compareRuns
+//===============================================================================
+
+///
+/// Prints the detection changes between the golden run and the current one,
+/// returns the number of images whose targets changed
+///
+static int compareRuns (const GoldenRun& golden, const GoldenRun& current) {
+    std::map<std::string, size_t> index;
+    for (size_t i = 0; i < golden.names.size(); ++i)
+        index[golden.names[i]] = i;
+
+    int changes = 0;
+    for (size_t i = 0; i < current.names.size(); ++i) {
+        const std::string& name = current.names[i];
+        std::map<std::string, size_t>::iterator it = index.find (name);
+
+        if (it == index.end()) {
+            printf ("  %s: not in the golden file\n", name.c_str());
+            ++changes;
+            continue;
+        }
+
+        if (!compareTargets (name, golden.reports[it->second], current.reports[i]))
+            ++changes;
+
+        index.erase (it);
+    }
+
+    for (const auto& missing : index) {
+        printf ("  %s: missing from the corpus\n", missing.first.c_str());
+        ++changes;
+    }
+
+    return changes;
+}
+
+//===============================================================================
+// Main entry point
+//===============================================================================
+
+int main (int argc, char** argv) {
+    std::string directory = Corpus::kDefaultDirectory;
+    std::string path = Golden::kDefaultPath;
+    bool update = false;
+    double fps = 0;
+    int passes = 3;
+    double maxSlowdown = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp (argv[i], "--images") == 0 && i + 1 < argc)
+            directory = argv[++i];
+
+        else if (strcmp (argv[i], "--golden") == 0 && i + 1 < argc)
+            path = argv[++i];
+
+        else if (strcmp (argv[i], "--update") == 0)
+            update = true;
+
+        else if (strcmp (argv[i], "--fps") == 0 && i + 1 < argc)
+            fps = atof (argv[++i]);
+
+        else if (strcmp (argv[i], "--passes") == 0 && i + 1 < argc)
+            passes = atoi (argv[++i]);
+
+        else if (strcmp (argv[i], "--max-slowdown") == 0 && i + 1 < argc)
+            maxSlowdown = atof (argv[++i]);
+
+        else
+            return usage (argv[0]);
+    }
+
+    std::vector<CorpusImage> images;
+    if (!Corpus::load (directory, images)) {
+        fprintf (stderr, "No images found in %s\n", directory.c_str());
+        return EXIT_FAILURE;
+    }
+
+    GoldenRun current;
+    replay (images, fps, passes > 0 ? passes : 1, current);
+
+    GoldenRun golden;
+    FILE* existing = fopen (path.c_str(), "r");
+    if (existing)
+        fclose (existing);
+
+    if (update || !existing) {
+        if (!Golden::write (path, current)) {
+            fprintf (stderr, "Cannot write %s\n", path.c_str());
+            return EXIT_FAILURE;
+        }
+
+        printf ("Golden:    %s written\n", path.c_str());
+        return EXIT_SUCCESS;
+    }
+
+    if (!Golden::read (path, golden)) {
+        fprintf (stderr, "Cannot read %s\n", path.c_str());
+        return EXIT_FAILURE;
+    }
+
+    printf ("Changes:\n");
+    int changes = compareRuns (golden, current);
+    printf ("Targets:   %d/%zu images changed\n", changes, current.names.size());
+
+    double slowdown = 0;
+    if (golden.meanMs > 0)
+        slowdown = 100 * (current.meanMs - golden.meanMs) / golden.meanMs;
+
+    printf ("Time:      %.3f ms -> %.3f ms per frame (%+.1f%%)\n",
+            golden.meanMs, current.meanMs, slowdown);
+
+    if (changes > 0)
+        return EXIT_FAILURE;
+
+    if (maxSlowdown >= 0 && slowdown > maxSlowdown) {
+        fprintf (stderr, "Slower than allowed (%.1f%%)\n", maxSlowdown);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
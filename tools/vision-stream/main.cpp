@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+
+#include "common/corpus.h"
+#include "common/timing.h"
+#include "common/replay_source.h"
+#include "vision/vision_thread.h"
+
+///
+/// Drives a VisionThread with the image corpus, played at the frame rate
+/// of the camera, while the main thread reads the results every 20 ms like
+/// the robot loop does.
+///
+/// Each result is compared with the report of the same image processed
+/// directly by a Pipeline, the program fails if any of them differs.
+///
+/// Usage: vision-stream [--images <dir>] [--fps <n>] [--passes <n>]
+///
+
+//===============================================================================
+// usage
+//===============================================================================
+
+static int usage (const char* name) {
+    fprintf (stderr, "Usage: %s [--images <dir>] [--fps <n>] [--passes <n>]\n", name);
+    return EXIT_FAILURE;
+}
+
+//===============================================================================
+// report
+//===============================================================================
+
+static void report (const char* label, const LatencyStats& stats) {
+    printf ("%-10s p50 %7.3f ms   p99 %7.3f ms   mean %7.3f ms\n",
+            label,
+            stats.percentile (50),
+            stats.percentile (99),
+            stats.mean());
+}
+
+//===============================================================================
+// sameReport
+//===============================================================================
+
+static bool sameReport (const ContoursReport& a, const ContoursReport& b) {
+    return a.count == b.count &&
+           memcmp (a.targets, b.targets, a.count * sizeof (Target)) == 0;
+}
+
+//===============================================================================
+// Main entry point
+//===============================================================================
+
+int main (int argc, char** argv) {
+    std::string directory = Corpus::kDefaultDirectory;
+    double fps = 30;
+    int passes = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp (argv[i], "--images") == 0 && i + 1 < argc)
+            directory = argv[++i];
+
+        else if (strcmp (argv[i], "--fps") == 0 && i + 1 < argc)
+            fps = atof (argv[++i]);
+
+        else if (strcmp (argv[i], "--passes") == 0 && i + 1 < argc)
+            passes = atoi (argv[++i]);
+
+        else
+            return usage (argv[0]);
+    }
+
+    std::vector<CorpusImage> images;
+    if (!Corpus::load (directory, images)) {
+        fprintf (stderr, "No images found in %s\n", directory.c_str());
+        return EXIT_FAILURE;
+    }
+
+    /* Expected report of each image */
+    Pipeline pipeline;
+    std::vector<ContoursReport> expected (images.size());
+    for (size_t i = 0; i < images.size(); ++i)
+        pipeline.process (images[i].frame, expected[i]);
+
+    ReplaySource source (images, fps, passes);
+    VisionThread vision (&source);
+    vision.start();
+
+    VisionResult result;
+    LatencyStats processing;
+    LatencyStats age;
+    uint32_t last = UINT32_MAX;
+    int mismatches = 0;
+    int loops = 0;
+
+    while (vision.running()) {
+        std::this_thread::sleep_for (std::chrono::milliseconds (20));
+        ++loops;
+
+        if (!vision.latest (result))
+            continue;
+
+        age.add (1000 * (source.now() - result.timestamp));
+        if (result.frame == last)
+            continue;
+
+        last = result.frame;
+        processing.add (result.processingMs);
+
+        if (!sameReport (result.report, expected[result.frame % images.size()])) {
+            fprintf (stderr, "Report differs for %s\n", source.image (result.frame).name.c_str());
+            ++mismatches;
+        }
+    }
+
+    vision.stop();
+
+    printf ("Frames:    %u captured, %u processed, %u dropped (%.0f fps source)\n",
+            vision.captured(), vision.processed(), vision.dropped(), fps);
+    printf ("Loop:      %d iterations, %zu new results\n", loops, processing.count());
+    report ("Pipeline:", processing);
+    report ("Age:", age);
+    printf ("Exact:     %d results differ\n", mismatches);
+
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
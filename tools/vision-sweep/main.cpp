@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2016 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "common/corpus.h"
+#include "common/timing.h"
+#include "common/thread_pool.h"
+#include "vision/pipeline.h"
+
+///
+/// Runs the vision pipeline over the image corpus with a grid of settings,
+/// to tune the values of KZ16.grip, and prints the detection statistics of
+/// each combination.
+///
+/// The threshold ranges are tuned by widening (or narrowing, with negative
+/// values) the hue, saturation and value ranges of both HSV thresholds of
+/// the default settings.
+///
+/// The images are decoded (or mapped from a frame cache) once and shared by
+/// all the combinations. The work
+/// is split in (threshold, group of images) tasks run by a ThreadPool: each
+/// task computes the mask of its images once, dilates it once per dilate
+/// value and labels the blobs once per dilated mask, the min area values
+/// only change which blobs are counted.
+///
+/// Usage: vision-sweep [--images <dir>] [--threads <n>] [--hue <list>]
+///                     [--sat <list>] [--val <list>] [--dilate <list>]
+///                     [--min-area <list>]
+///
+/// Lists are comma separated, for example: --dilate 1,2,3
+///
+
+static const int kImagesPerTask = 16;
+
+///
+/// Detection statistics of one combination of settings
+///
+struct SweepStats {
+    std::atomic<int> targets;
+    std::atomic<int> frames;
+    std::atomic<long> halfArea;
+
+    SweepStats() : targets (0), frames (0), halfArea (0) {}
+};
+
+///
+/// Buffers used by each worker of the pool
+///
+struct SweepWorker {
+    FusedThreshold fused;
+    BlobLabeller blobs;
+    Frame mask;
+    Frame scratch;
+    Frame dilated;
+
+    SweepWorker() : fused (FusedThreshold::kConversion) {}
+};
+
+//===============================================================================
+// usage
+//===============================================================================
+
+static int usage (const char* name) {
+    fprintf (stderr, "Usage: %s [--images <dir>] [--threads <n>] [--hue <list>] "
+             "[--sat <list>] [--val <list>] [--dilate <list>] [--min-area <list>]\n", name);
+    return EXIT_FAILURE;
+}
+
+//===============================================================================
+// parseList
+//===============================================================================
+
+static std::vector<double> parseList (const char* text) {
+    std::vector<double> values;
+    char* end = nullptr;
+
+    for (const char* p = text; *p; p = *end ? end + 1 : end) {
+        values.push_back (strtod (p, &end));
+        if (end == p)
+            break;
+    }
+
+    return values;
+}
+
+//===============================================================================
+// count
+//===============================================================================
+
+///
+/// Returns the number of targets that the pipeline would report with the
+/// given settings, and adds their area to \a halfArea (in half pixels, the
+/// contour areas are multiples of 0.5)
+///
+static int count (const BlobLabeller& blobs, const PipelineSettings& settings, long& halfArea) {
+    int targets = 0;
+
+    for (int i = 0; i < blobs.count() && targets < kMaxTargets; ++i) {
+        const Blob& blob = blobs.blob (i);
+        if (Pipeline::accepts (blob, settings)) {
+            halfArea += lround (blob.area * 2);
+            ++targets;
+        }
+    }
+
+    return targets;
+}
+
+//===============================================================================
+// widen
+//===============================================================================
+
+static void widen (double range[2], double amount, double max) {
+    range[0] = std::max (0.0, range[0] - amount);
+    range[1] = std::min (max, range[1] + amount);
+}
+
+//===============================================================================
+// Main entry point
+//===============================================================================
+
+int main (int argc, char** argv) {
+    std::string directory = Corpus::kDefaultDirectory;
+    int threads = 0;
+    std::vector<double> hue = { -5, 0, 5 };
+    std::vector<double> sat = { -10, 0, 10 };
+    std::vector<double> val = { -10, 0, 10 };
+    std::vector<double> dilate = { 1, 2, 3 };
+    std::vector<double> minArea = { 200, 400, 800 };
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp (argv[i], "--images") == 0 && i + 1 < argc)
+            directory = argv[++i];
+
+        else if (strcmp (argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi (argv[++i]);
+
+        else if (strcmp (argv[i], "--hue") == 0 && i + 1 < argc)
+            hue = parseList (argv[++i]);
+
+        else if (strcmp (argv[i], "--sat") == 0 && i + 1 < argc)
+            sat = parseList (argv[++i]);
+
+        else if (strcmp (argv[i], "--val") == 0 && i + 1 < argc)
+            val = parseList (argv[++i]);
+
+        else if (strcmp (argv[i], "--dilate") == 0 && i + 1 < argc)
+            dilate = parseList (argv[++i]);
+
+        else if (strcmp (argv[i], "--min-area") == 0 && i + 1 < argc)
+            minArea = parseList (argv[++i]);
+
+        else
+            return usage (argv[0]);
+    }
+
+    if (hue.empty() || sat.empty() || val.empty() || dilate.empty() || minArea.empty())
+        return usage (argv[0]);
+
+    ThreadPool pool (threads);
+    Stopwatch total;
+
+    /* Map the frame cache, or decode the images in parallel */
+    std::vector<CorpusImage> images;
+    std::vector<Frame> frames;
+    std::atomic<int> failures (0);
+
+    if (FrameCache::isCache (directory)) {
+        if (!Corpus::load (directory, images))
+            ++failures;
+
+        for (const CorpusImage& image : images)
+            frames.push_back (image.frame);
+    }
+
+    else {
+        std::vector<std::string> paths = Corpus::list (directory);
+        frames.resize (paths.size());
+
+        for (size_t i = 0; i < paths.size(); ++i) {
+            pool.submit ([&, i] (int) {
+                if (!Corpus::decode (paths[i], frames[i]))
+                    ++failures;
+            });
+        }
+
+        pool.wait();
+    }
+
+    const double decodeMs = total.elapsedMs();
+
+    if (frames.empty() || failures > 0) {
+        fprintf (stderr, "Cannot load the images of %s\n", directory.c_str());
+        return EXIT_FAILURE;
+    }
+
+    /* Build the list of thresholds */
+    const PipelineSettings defaults;
+    std::vector<PipelineSettings> thresholds;
+
+    for (double h : hue) {
+        for (double s : sat) {
+            for (double v : val) {
+                PipelineSettings settings = defaults;
+                widen (settings.thresholdA.hue, h, 180);
+                widen (settings.thresholdB.hue, h, 180);
+                widen (settings.thresholdA.sat, s, 255);
+                widen (settings.thresholdB.sat, s, 255);
+                widen (settings.thresholdA.val, v, 255);
+                widen (settings.thresholdB.val, v, 255);
+                thresholds.push_back (settings);
+            }
+        }
+    }
+
+    const size_t dilates = dilate.size();
+    const size_t areas = minArea.size();
+    const double smallestArea = *std::min_element (minArea.begin(), minArea.end());
+
+    std::vector<SweepStats> stats (thresholds.size() * dilates * areas);
+    std::vector<SweepWorker> workers (pool.size());
+
+    /* Run every combination */
+    Stopwatch sweep;
+    for (size_t t = 0; t < thresholds.size(); ++t) {
+        for (size_t first = 0; first < frames.size(); first += kImagesPerTask) {
+            pool.submit ([&, t, first] (int index) {
+                SweepWorker& worker = workers[index];
+                PipelineSettings settings = thresholds[t];
+                const size_t last = std::min (frames.size(), first + kImagesPerTask);
+
+                for (size_t i = first; i < last; ++i) {
+                    worker.fused.process (frames[i], settings.thresholdA,
+                                          settings.thresholdB, worker.mask);
+
+                    for (size_t d = 0; d < dilates; ++d) {
+                        Steps::dilate (worker.mask, (int) dilate[d], worker.scratch,
+                                       worker.dilated);
+                        worker.blobs.find (worker.dilated, (int) ceil (smallestArea));
+
+                        for (size_t a = 0; a < areas; ++a) {
+                            long halfArea = 0;
+                            settings.minArea = minArea[a];
+
+                            const int targets = count (worker.blobs, settings, halfArea);
+                            SweepStats& result = stats[(t * dilates + d) * areas + a];
+                            result.targets += targets;
+                            result.frames += targets > 0;
+                            result.halfArea += halfArea;
+                        }
+                    }
+                }
+            });
+        }
+    }
+
+    pool.wait();
+    const double sweepMs = sweep.elapsedMs();
+
+    /* Print the results as CSV, the defaults are marked with a '*' */
+    printf ("hue,sat,val,dilate,min_area,targets,frames,targets_per_frame,mean_area\n");
+
+    size_t t = 0;
+    for (double h : hue) {
+        for (double s : sat) {
+            for (double v : val) {
+                for (size_t d = 0; d < dilates; ++d) {
+                    for (size_t a = 0; a < areas; ++a) {
+                        const SweepStats& result = stats[(t * dilates + d) * areas + a];
+                        const bool isDefault = h == 0 && s == 0 && v == 0 &&
+                                               dilate[d] == defaults.dilateIterations &&
+                                               minArea[a] == defaults.minArea;
+
+                        printf ("%g,%g,%g,%g,%g,%d,%d,%.3f,%.1f%s\n",
+                                h, s, v, dilate[d], minArea[a],
+                                result.targets.load(),
+                                result.frames.load(),
+                                (double) result.targets / frames.size(),
+                                result.targets > 0 ?
+                                    result.halfArea / 2.0 / result.targets : 0,
+                                isDefault ? ",*" : "");
+                    }
+                }
+
+                ++t;
+            }
+        }
+    }
+
+    fprintf (stderr, "%zu images, %zu combinations, %d threads: loaded in %.0f ms, "
+             "swept in %.0f ms (%.0f images per second for each threshold)\n",
+             frames.size(), stats.size(), pool.size(), decodeMs, sweepMs,
+             1000.0 * frames.size() * thresholds.size() / sweepMs);
+
+    return EXIT_SUCCESS;
+}